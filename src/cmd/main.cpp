@@ -122,9 +122,13 @@ int main(int argc, const char* argv[])
                      const Peer& from) mutable -> vector<Peer> {
         return zilliqa.RetrieveBroadcastList(msg_type, ins_type, from);
     };
+    auto ready_checker = [&zilliqa](unsigned char msg_type) -> bool {
+        return zilliqa.IsReady(msg_type);
+    };
 
-    P2PComm::GetInstance().StartMessagePump(
-        my_network_info.m_listenPortHost, dispatcher, broadcast_list_retriever);
+    P2PComm::GetInstance().StartMessagePump(my_network_info.m_listenPortHost,
+                                            dispatcher, broadcast_list_retriever,
+                                            ready_checker);
 
     return 0;
 }
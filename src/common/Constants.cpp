@@ -128,11 +128,49 @@ const unsigned int DEBUG_LEVEL{ReadFromConstantsFile("DEBUG_LEVEL")};
 const unsigned int BROADCAST_INTERVAL{
     ReadFromConstantsFile("BROADCAST_INTERVAL")};
 const unsigned int BROADCAST_EXPIRY{ReadFromConstantsFile("BROADCAST_EXPIRY")};
-const unsigned int SENDQUEUE_SIZE{ReadFromConstantsFile("SENDQUEUE_SIZE")};
+const unsigned int SENDQUEUE_SIZE_CONSENSUS{
+    ReadFromConstantsFile("SENDQUEUE_SIZE_CONSENSUS")};
+const unsigned int SENDQUEUE_SIZE_BLOCK{
+    ReadFromConstantsFile("SENDQUEUE_SIZE_BLOCK")};
+const unsigned int SENDQUEUE_SIZE_TRANSACTION{
+    ReadFromConstantsFile("SENDQUEUE_SIZE_TRANSACTION")};
+const unsigned int SENDQUEUE_SIZE_SYNC{
+    ReadFromConstantsFile("SENDQUEUE_SIZE_SYNC")};
 const unsigned int MSGQUEUE_SIZE{ReadFromConstantsFile("MSGQUEUE_SIZE")};
+const unsigned int PEER_MSG_THREADS{ReadFromConstantsFile("PEER_MSG_THREADS")};
+const unsigned int DIRECTORY_MSG_THREADS{
+    ReadFromConstantsFile("DIRECTORY_MSG_THREADS")};
+const unsigned int NODE_MSG_THREADS{ReadFromConstantsFile("NODE_MSG_THREADS")};
+const unsigned int LOOKUP_MSG_THREADS{
+    ReadFromConstantsFile("LOOKUP_MSG_THREADS")};
 const unsigned int POW_CHANGE_PERCENT_TO_ADJ_DIFF{
     ReadFromConstantsFile("POW_CHANGE_PERCENT_TO_ADJ_DIFF")};
 const unsigned int NUM_NETWORK_NODE{ReadFromConstantsFile("NUM_NETWORK_NODE")};
+const unsigned int MAX_MESSAGE_SIZE{ReadFromConstantsFile("MAX_MESSAGE_SIZE")};
+const unsigned int MAX_PEER_CONNECTIONS{
+    ReadFromConstantsFile("MAX_PEER_CONNECTIONS")};
+const unsigned int CONNECTION_IDLE_TIMEOUT_IN_SECONDS{
+    ReadFromConstantsFile("CONNECTION_IDLE_TIMEOUT_IN_SECONDS")};
+const unsigned int RECONNECT_BACKOFF_BASE_IN_MS{
+    ReadFromConstantsFile("RECONNECT_BACKOFF_BASE_IN_MS")};
+const unsigned int RECONNECT_BACKOFF_MAX_IN_MS{
+    ReadFromConstantsFile("RECONNECT_BACKOFF_MAX_IN_MS")};
+const unsigned int MULTICAST_PARALLELISM{
+    ReadFromConstantsFile("MULTICAST_PARALLELISM")};
+const unsigned int MULTICAST_POOL_SIZE{
+    ReadFromConstantsFile("MULTICAST_POOL_SIZE")};
+const unsigned int NUM_EVENT_REACTORS{
+    ReadFromConstantsFile("NUM_EVENT_REACTORS")};
+const unsigned int GOSSIP_FANOUT{ReadFromConstantsFile("GOSSIP_FANOUT")};
+const unsigned int GOSSIP_ROUNDS{ReadFromConstantsFile("GOSSIP_ROUNDS")};
+const unsigned int GOSSIP_ROUND_INTERVAL_IN_MS{
+    ReadFromConstantsFile("GOSSIP_ROUND_INTERVAL_IN_MS")};
+const unsigned int COMPRESSION_THRESHOLD_IN_BYTES{
+    ReadFromConstantsFile("COMPRESSION_THRESHOLD_IN_BYTES")};
+const unsigned int PUBKEY_CACHE_SIZE{
+    ReadFromConstantsFile("PUBKEY_CACHE_SIZE")};
+const unsigned int COMMIT_POOL_SIZE{
+    ReadFromConstantsFile("COMMIT_POOL_SIZE")};
 
 const bool EXCLUDE_PRIV_IP{
     ReadFromOptionsFile("EXCLUDE_PRIV_IP") == "true" ? true : false};
@@ -146,6 +184,15 @@ const bool OPENCL_GPU_MINE{
     ReadFromOptionsFile("OPENCL_GPU_MINE") == "true" ? true : false};
 const bool CUDA_GPU_MINE{
     ReadFromOptionsFile("CUDA_GPU_MINE") == "true" ? true : false};
+const bool PERSISTENT_CONNECTION{
+    ReadFromOptionsFile("PERSISTENT_CONNECTION") == "true" ? true : false};
+const bool BROADCAST_GOSSIP_MODE{
+    ReadFromOptionsFile("BROADCAST_GOSSIP_MODE") == "true" ? true : false};
+const bool BROADCAST_DEDUP_BLOOM_FILTER{
+    ReadFromOptionsFile("BROADCAST_DEDUP_BLOOM_FILTER") == "true" ? true
+                                                                  : false};
+const bool WIRE_COMPRESSION{
+    ReadFromOptionsFile("WIRE_COMPRESSION") == "true" ? true : false};
 
 const std::vector<std::string> GENESIS_WALLETS{
     ReadAccountsFromConstantsFile("wallet_address")};
@@ -140,10 +140,31 @@ extern const unsigned int TXN_BROADCAST;
 extern const unsigned int DEBUG_LEVEL;
 extern const unsigned int BROADCAST_INTERVAL;
 extern const unsigned int BROADCAST_EXPIRY;
-extern const unsigned int SENDQUEUE_SIZE;
+extern const unsigned int SENDQUEUE_SIZE_CONSENSUS;
+extern const unsigned int SENDQUEUE_SIZE_BLOCK;
+extern const unsigned int SENDQUEUE_SIZE_TRANSACTION;
+extern const unsigned int SENDQUEUE_SIZE_SYNC;
 extern const unsigned int MSGQUEUE_SIZE;
+extern const unsigned int PEER_MSG_THREADS;
+extern const unsigned int DIRECTORY_MSG_THREADS;
+extern const unsigned int NODE_MSG_THREADS;
+extern const unsigned int LOOKUP_MSG_THREADS;
 extern const unsigned int POW_CHANGE_PERCENT_TO_ADJ_DIFF;
 extern const unsigned int NUM_NETWORK_NODE;
+extern const unsigned int MAX_MESSAGE_SIZE;
+extern const unsigned int MAX_PEER_CONNECTIONS;
+extern const unsigned int CONNECTION_IDLE_TIMEOUT_IN_SECONDS;
+extern const unsigned int RECONNECT_BACKOFF_BASE_IN_MS;
+extern const unsigned int RECONNECT_BACKOFF_MAX_IN_MS;
+extern const unsigned int MULTICAST_PARALLELISM;
+extern const unsigned int MULTICAST_POOL_SIZE;
+extern const unsigned int NUM_EVENT_REACTORS;
+extern const unsigned int GOSSIP_FANOUT;
+extern const unsigned int GOSSIP_ROUNDS;
+extern const unsigned int GOSSIP_ROUND_INTERVAL_IN_MS;
+extern const unsigned int COMPRESSION_THRESHOLD_IN_BYTES;
+extern const unsigned int PUBKEY_CACHE_SIZE;
+extern const unsigned int COMMIT_POOL_SIZE;
 
 extern const bool TEST_NET_MODE;
 extern const bool EXCLUDE_PRIV_IP;
@@ -151,6 +172,10 @@ extern const bool ENABLE_DO_REJOIN;
 extern const bool FULL_DATASET_MINE;
 extern const bool OPENCL_GPU_MINE;
 extern const bool CUDA_GPU_MINE;
+extern const bool PERSISTENT_CONNECTION;
+extern const bool BROADCAST_GOSSIP_MODE;
+extern const bool BROADCAST_DEDUP_BLOOM_FILTER;
+extern const bool WIRE_COMPRESSION;
 
 extern const std::vector<std::string> GENESIS_WALLETS;
 extern const std::vector<std::string> GENESIS_KEYS;
@@ -17,8 +17,110 @@
 #ifndef __SERIALIZABLE_H__
 #define __SERIALIZABLE_H__
 
+#include <algorithm>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+/// Big-endian encoding of a number into a fixed number of bytes, one byte at a time.
+template<class numerictype> class BigEndianNumber
+{
+public:
+    static numerictype Get(const std::vector<unsigned char>& src,
+                           unsigned int offset, unsigned int numerictype_len)
+    {
+        numerictype result = 0;
+
+        if (offset + numerictype_len <= src.size())
+        {
+            unsigned int left_shift = (numerictype_len - 1) * 8;
+            for (unsigned int i = 0; i < numerictype_len; i++)
+            {
+                numerictype tmp = src.at(offset + i);
+                result += (tmp << left_shift);
+                left_shift -= 8;
+            }
+        }
+
+        return result;
+    }
+
+    static void Set(std::vector<unsigned char>& dst, unsigned int offset,
+                    const numerictype& value, unsigned int numerictype_len)
+    {
+        unsigned int right_shift = (numerictype_len - 1) * 8;
+        for (unsigned int i = 0; i < numerictype_len; i++)
+        {
+            dst.at(offset + i)
+                = static_cast<unsigned char>((value >> right_shift) & 0xFF);
+            right_shift -= 8;
+        }
+    }
+};
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/// Fixed-width boost integers (uint128_t, uint256_t) keep their value in a
+/// fixed limb array, which on little-endian hosts is the value's bytes in
+/// reverse order. Reversing a copy of it replaces one full-width shift per byte.
+template<unsigned int Bits>
+class BigEndianNumber<boost::multiprecision::number<
+    boost::multiprecision::cpp_int_backend<
+        Bits, Bits, boost::multiprecision::unsigned_magnitude,
+        boost::multiprecision::unchecked, void>>>
+{
+    typedef boost::multiprecision::number<
+        boost::multiprecision::cpp_int_backend<
+            Bits, Bits, boost::multiprecision::unsigned_magnitude,
+            boost::multiprecision::unchecked, void>>
+        Number;
+    typedef typename std::remove_pointer<decltype(
+        std::declval<Number&>().backend().limbs())>::type Limb;
+
+    static const unsigned int LIMB_COUNT
+        = (Bits + sizeof(Limb) * 8 - 1) / (sizeof(Limb) * 8);
+    static const unsigned int WIDTH = LIMB_COUNT * sizeof(Limb);
+
+public:
+    static Number Get(const std::vector<unsigned char>& src,
+                      unsigned int offset, unsigned int numerictype_len)
+    {
+        Number result = 0;
+
+        if (offset + numerictype_len <= src.size())
+        {
+            // Only the low WIDTH bytes can land in the value
+            const unsigned int len = std::min(numerictype_len, WIDTH);
+            const auto end = src.begin() + offset + numerictype_len;
+            unsigned char buf[WIDTH] = {};
+            std::reverse_copy(end - len, end, buf);
+
+            result.backend().resize(LIMB_COUNT, LIMB_COUNT);
+            memcpy(result.backend().limbs(), buf, WIDTH);
+            result.backend().normalize();
+        }
+
+        return result;
+    }
+
+    static void Set(std::vector<unsigned char>& dst, unsigned int offset,
+                    const Number& value, unsigned int numerictype_len)
+    {
+        unsigned char buf[WIDTH] = {};
+        memcpy(buf, value.backend().limbs(),
+               value.backend().size() * sizeof(Limb));
+
+        // Wider fields are zero-padded, narrower ones keep the low bytes
+        const unsigned int len = std::min(numerictype_len, WIDTH);
+        const auto begin = dst.begin() + offset;
+        std::fill(begin, begin + numerictype_len - len, 0);
+        std::reverse_copy(buf, buf + len, begin + numerictype_len - len);
+    }
+};
+#endif
+
 /// Specifies the interface required for classes that are byte serializable.
 class Serializable
 {
@@ -42,20 +144,7 @@ public:
                                  unsigned int offset,
                                  unsigned int numerictype_len)
     {
-        numerictype result = 0;
-
-        if (offset + numerictype_len <= src.size())
-        {
-            unsigned int left_shift = (numerictype_len - 1) * 8;
-            for (unsigned int i = 0; i < numerictype_len; i++)
-            {
-                numerictype tmp = src.at(offset + i);
-                result += (tmp << left_shift);
-                left_shift -= 8;
-            }
-        }
-
-        return result;
+        return BigEndianNumber<numerictype>::Get(src, offset, numerictype_len);
     }
 
     /// Template function for placing a number into the destination byte stream at the specified offset.
@@ -71,13 +160,7 @@ public:
             dst.resize(dst.size() + numerictype_len - length_available);
         }
 
-        unsigned int right_shift = (numerictype_len - 1) * 8;
-        for (unsigned int i = 0; i < numerictype_len; i++)
-        {
-            dst.at(offset + i)
-                = static_cast<unsigned char>((value >> right_shift) & 0xFF);
-            right_shift -= 8;
-        }
+        BigEndianNumber<numerictype>::Set(dst, offset, value, numerictype_len);
     }
 };
 
@@ -25,6 +25,10 @@
 #include "SHA3.h"
 #include "RLP.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
 using namespace std;
 using namespace dev;
 
@@ -62,16 +66,6 @@ namespace dev
 /******** The Keccak-f[1600] permutation ********/
 
 /*** Constants. ***/
-        static const uint8_t rho[24] = \
-  { 1,  3,   6, 10, 15, 21,
-    28, 36, 45, 55,  2, 14,
-    27, 41, 56,  8, 25, 43,
-    62, 18, 39, 61, 20, 44};
-        static const uint8_t pi[24] = \
-  {10,  7, 11, 17, 18, 3,
-   5, 16,  8, 21, 24, 4,
-   15, 23, 19, 13, 12, 2,
-   20, 14, 22,  9, 6,  1};
         static const uint64_t RC[24] = \
   {1ULL, 0x8082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
    0x808bULL, 0x80000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
@@ -80,48 +74,113 @@ namespace dev
    0x8000000000008002ULL, 0x8000000000000080ULL, 0x800aULL, 0x800000008000000aULL,
    0x8000000080008081ULL, 0x8000000000008080ULL, 0x80000001ULL, 0x8000000080008008ULL};
 
-/*** Helper macros to unroll the permutation. ***/
-#define rol(x, s) (((x) << s) | ((x) >> (64 - s)))
-#define REPEAT6(e) e e e e e e
-#define REPEAT24(e) REPEAT6(e e e e)
-#define REPEAT5(e) e e e e e
-#define FOR5(v, s, e) \
-  v = 0;            \
-  REPEAT5(e; v += s;)
-
-/*** Keccak-f[1600] ***/
-        static inline void keccakf(void* state) {
-            uint64_t* a = (uint64_t*)state;
-            uint64_t b[5] = {0};
-            uint64_t t = 0;
-            uint8_t x, y;
+/*** Keccak-f[1600], unrolled over the 25 64-bit lanes. ***/
+        static inline uint64_t rol(uint64_t x, unsigned s) {
+            return (x << s) | (x >> (64 - s));
+        }
 
-            for (int i = 0; i < 24; i++) {
+        static inline __attribute__((always_inline)) void keccakf_rounds(uint64_t* a) {
+            for (int round = 0; round < 24; round++) {
                 // Theta
-                FOR5(x, 1,
-                     b[x] = 0;
-                             FOR5(y, 5,
-                                  b[x] ^= a[x + y]; ))
-                FOR5(x, 1,
-                     FOR5(y, 5,
-                          a[y + x] ^= b[(x + 4) % 5] ^ rol(b[(x + 1) % 5], 1); ))
+                const uint64_t c0 = a[0] ^ a[5] ^ a[10] ^ a[15] ^ a[20];
+                const uint64_t c1 = a[1] ^ a[6] ^ a[11] ^ a[16] ^ a[21];
+                const uint64_t c2 = a[2] ^ a[7] ^ a[12] ^ a[17] ^ a[22];
+                const uint64_t c3 = a[3] ^ a[8] ^ a[13] ^ a[18] ^ a[23];
+                const uint64_t c4 = a[4] ^ a[9] ^ a[14] ^ a[19] ^ a[24];
+                const uint64_t d0 = c4 ^ rol(c1, 1);
+                const uint64_t d1 = c0 ^ rol(c2, 1);
+                const uint64_t d2 = c1 ^ rol(c3, 1);
+                const uint64_t d3 = c2 ^ rol(c4, 1);
+                const uint64_t d4 = c3 ^ rol(c0, 1);
+
                 // Rho and pi
-                t = a[1];
-                x = 0;
-                REPEAT24(b[0] = a[pi[x]];
-                                 a[pi[x]] = rol(t, rho[x]);
-                                 t = b[0];
-                                 x++; )
+                const uint64_t b0 = a[0] ^ d0;
+                const uint64_t b1 = rol(a[6] ^ d1, 44);
+                const uint64_t b2 = rol(a[12] ^ d2, 43);
+                const uint64_t b3 = rol(a[18] ^ d3, 21);
+                const uint64_t b4 = rol(a[24] ^ d4, 14);
+                const uint64_t b5 = rol(a[3] ^ d3, 28);
+                const uint64_t b6 = rol(a[9] ^ d4, 20);
+                const uint64_t b7 = rol(a[10] ^ d0, 3);
+                const uint64_t b8 = rol(a[16] ^ d1, 45);
+                const uint64_t b9 = rol(a[22] ^ d2, 61);
+                const uint64_t b10 = rol(a[1] ^ d1, 1);
+                const uint64_t b11 = rol(a[7] ^ d2, 6);
+                const uint64_t b12 = rol(a[13] ^ d3, 25);
+                const uint64_t b13 = rol(a[19] ^ d4, 8);
+                const uint64_t b14 = rol(a[20] ^ d0, 18);
+                const uint64_t b15 = rol(a[4] ^ d4, 27);
+                const uint64_t b16 = rol(a[5] ^ d0, 36);
+                const uint64_t b17 = rol(a[11] ^ d1, 10);
+                const uint64_t b18 = rol(a[17] ^ d2, 15);
+                const uint64_t b19 = rol(a[23] ^ d3, 56);
+                const uint64_t b20 = rol(a[2] ^ d2, 62);
+                const uint64_t b21 = rol(a[8] ^ d3, 55);
+                const uint64_t b22 = rol(a[14] ^ d4, 39);
+                const uint64_t b23 = rol(a[15] ^ d0, 41);
+                const uint64_t b24 = rol(a[21] ^ d1, 2);
+
                 // Chi
-                FOR5(y,
-                     5,
-                     FOR5(x, 1,
-                          b[x] = a[y + x];)
-                             FOR5(x, 1,
-                             a[y + x] = b[x] ^ ((~b[(x + 1) % 5]) & b[(x + 2) % 5]); ))
+                a[0] = b0 ^ (~b1 & b2);
+                a[1] = b1 ^ (~b2 & b3);
+                a[2] = b2 ^ (~b3 & b4);
+                a[3] = b3 ^ (~b4 & b0);
+                a[4] = b4 ^ (~b0 & b1);
+                a[5] = b5 ^ (~b6 & b7);
+                a[6] = b6 ^ (~b7 & b8);
+                a[7] = b7 ^ (~b8 & b9);
+                a[8] = b8 ^ (~b9 & b5);
+                a[9] = b9 ^ (~b5 & b6);
+                a[10] = b10 ^ (~b11 & b12);
+                a[11] = b11 ^ (~b12 & b13);
+                a[12] = b12 ^ (~b13 & b14);
+                a[13] = b13 ^ (~b14 & b10);
+                a[14] = b14 ^ (~b10 & b11);
+                a[15] = b15 ^ (~b16 & b17);
+                a[16] = b16 ^ (~b17 & b18);
+                a[17] = b17 ^ (~b18 & b19);
+                a[18] = b18 ^ (~b19 & b15);
+                a[19] = b19 ^ (~b15 & b16);
+                a[20] = b20 ^ (~b21 & b22);
+                a[21] = b21 ^ (~b22 & b23);
+                a[22] = b22 ^ (~b23 & b24);
+                a[23] = b23 ^ (~b24 & b20);
+                a[24] = b24 ^ (~b20 & b21);
+
                 // Iota
-                a[0] ^= RC[i];
+                a[0] ^= RC[round];
+            }
+        }
+
+        static void keccakf_generic(uint64_t* a) { keccakf_rounds(a); }
+
+#if defined(__x86_64__) || defined(__i386__)
+        // Same code; with BMI the compiler can use ANDN for chi and RORX for the rotations
+        __attribute__((target("bmi,bmi2"))) static void keccakf_bmi(uint64_t* a) { keccakf_rounds(a); }
+
+        static bool cpu_has_bmi() {
+            unsigned int eax, ebx, ecx, edx;
+            if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+                return false;
+            }
+            return (ebx & (1u << 3)) && (ebx & (1u << 8));
+        }
+#endif
+
+        typedef void (*keccakf_fn)(uint64_t*);
+
+        static keccakf_fn select_keccakf() {
+#if defined(__x86_64__) || defined(__i386__)
+            if (cpu_has_bmi()) {
+                return keccakf_bmi;
             }
+#endif
+            return keccakf_generic;
+        }
+
+        static inline void keccakf(void* state) {
+            static const keccakf_fn impl = select_keccakf();
+            impl((uint64_t*)state);
         }
 
 /******** The FIPS202-defined functions. ********/
@@ -131,12 +190,6 @@ namespace dev
 #define _(S) do { S } while (0)
 #define FOR(i, ST, L, S) \
   _(for (size_t i = 0; i < L; i += ST) { S; })
-#define mkapply_ds(NAME, S)                                          \
-  static inline void NAME(uint8_t* dst,                              \
-						  const uint8_t* src,                        \
-						  size_t len) {                              \
-	FOR(i, 1, len, S);                                               \
-  }
 #define mkapply_sd(NAME, S)                                          \
   static inline void NAME(const uint8_t* src,                        \
 						  uint8_t* dst,                              \
@@ -144,7 +197,21 @@ namespace dev
 	FOR(i, 1, len, S);                                               \
   }
 
-        mkapply_ds(xorin, dst[i] ^= src[i])  // xorin
+        // xorin, a 64-bit lane at a time while whole lanes are left
+        static inline void xorin(uint8_t* dst, const uint8_t* src, size_t len) {
+            size_t i = 0;
+            for (; i + 8 <= len; i += 8) {
+                uint64_t d, s;
+                memcpy(&d, dst + i, 8);
+                memcpy(&s, src + i, 8);
+                d ^= s;
+                memcpy(dst + i, &d, 8);
+            }
+            for (; i < len; i++) {
+                dst[i] ^= src[i];
+            }
+        }
+
         mkapply_sd(setout, dst[i] = src[i])  // setout
 
 #define P keccakf
@@ -166,7 +233,7 @@ namespace dev
             if ((out == NULL) || ((in == NULL) && inlen != 0) || (rate >= Plen)) {
                 return -1;
             }
-            uint8_t a[Plen] = {0};
+            alignas(8) uint8_t a[Plen] = {0};
             // Absorb input.
             foldP(in, inlen, xorin);
             // Xor in the DS and pad frame.
@@ -18,6 +18,7 @@
 #include "ConsensusBackup.h"
 #include "common/Constants.h"
 #include "common/Messages.h"
+#include "libCrypto/CommitPointPool.h"
 #include "libNetwork/P2PComm.h"
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
@@ -289,8 +290,7 @@ bool ConsensusBackup::GenerateCommitMessage(vector<unsigned char>& commit,
 
     // Generate new commit
     // ===================
-    m_commitSecret.reset(new CommitSecret());
-    m_commitPoint.reset(new CommitPoint(*m_commitSecret));
+    CommitPointPool::GetInstance().Take(m_commitSecret, m_commitPoint);
 
     // Assemble commit message body
     // ============================
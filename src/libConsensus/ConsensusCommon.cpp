@@ -18,6 +18,7 @@
 #include "ConsensusCommon.h"
 #include "common/Constants.h"
 #include "common/Messages.h"
+#include "libCrypto/CommitPointPool.h"
 #include "libNetwork/P2PComm.h"
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
@@ -72,6 +73,8 @@ ConsensusCommon::ConsensusCommon(uint32_t consensus_id,
     , m_insByte(ins_byte)
     , m_responseMap(committee.size(), false)
 {
+    // Start filling the commit pool before the first announcement needs it
+    CommitPointPool::GetInstance();
 }
 
 ConsensusCommon::~ConsensusCommon() {}
@@ -116,15 +119,11 @@ PubKey ConsensusCommon::AggregateKeys(const vector<bool> peer_map)
     LOG_MARKER();
 
     vector<PubKey> keys;
-    deque<pair<PubKey, Peer>>::const_iterator j = m_committee.begin();
-    for (unsigned int i = 0; i < peer_map.size(); i++, j++)
+    for (auto const& kv : m_committee)
     {
-        if (peer_map.at(i) == true)
-        {
-            keys.emplace_back(j->first);
-        }
+        keys.emplace_back(kv.first);
     }
-    shared_ptr<PubKey> result = MultiSig::AggregatePubKeys(keys);
+    shared_ptr<PubKey> result = MultiSig::AggregatePubKeys(keys, peer_map);
     if (result == nullptr)
     {
         return PubKey();
@@ -300,6 +299,38 @@ bool ConsensusCommon::CanProcessMessage(const vector<unsigned char>& message,
     return true;
 }
 
+bool ConsensusCommon::PreProcessInOrder(
+    unique_lock<mutex>& orderLock, unique_lock<mutex>& consensusLock,
+    const shared_ptr<ConsensusCommon>& consensusObject,
+    const vector<unsigned char>& message, unsigned int offset,
+    const Peer& from)
+{
+    orderLock.unlock();
+
+    consensusLock.lock();
+    shared_ptr<ConsensusCommon> checkedBy = consensusObject;
+    consensusLock.unlock();
+
+    if (checkedBy == nullptr
+        || !checkedBy->PreProcessMessage(message, offset, from))
+    {
+        return false;
+    }
+
+    orderLock.lock();
+    consensusLock.lock();
+
+    // A view change or rejoin may have replaced the object in the meantime
+    if (consensusObject != checkedBy)
+    {
+        LOG_GENERAL(WARNING,
+                    "Consensus object replaced while checking the message");
+        return false;
+    }
+
+    return checkedBy->CanProcessMessage(message, offset);
+}
+
 map<ConsensusCommon::State, string> ConsensusCommon::ConsensusStateStrings
     = {MAKE_LITERAL_PAIR(INITIAL),
        MAKE_LITERAL_PAIR(ANNOUNCE_DONE),
@@ -204,6 +204,15 @@ public:
         return false; // Should be implemented by ConsensusLeader and ConsensusBackup
     }
 
+    /// Checks the parts of a consensus message that don't depend on the order of arrival
+    /// (e.g., signatures). Thread-safe, so callers can run it before serializing the message.
+    virtual bool PreProcessMessage(
+        [[gnu::unused]] const std::vector<unsigned char>& message,
+        [[gnu::unused]] unsigned int offset, [[gnu::unused]] const Peer& from)
+    {
+        return true;
+    }
+
     /// Returns the state of the active consensus session
     State GetState() const;
 
@@ -238,6 +247,17 @@ public:
     bool CanProcessMessage(const std::vector<unsigned char>& message,
                            unsigned int offset);
 
+    /// Runs PreProcessMessage with the ordering lock and consensus lock released, so peers'
+    /// messages are checked in parallel, then takes both locks again in that order.
+    /// Returns true, with consensusLock held, only if consensusObject still points to the
+    /// object that checked the message and that object can still process it.
+    static bool
+    PreProcessInOrder(std::unique_lock<std::mutex>& orderLock,
+                      std::unique_lock<std::mutex>& consensusLock,
+                      const std::shared_ptr<ConsensusCommon>& consensusObject,
+                      const std::vector<unsigned char>& message,
+                      unsigned int offset, const Peer& from);
+
     /// Returns a string representation of the current state
     std::string GetStateString() const;
 
@@ -18,6 +18,7 @@
 #include "ConsensusLeader.h"
 #include "common/Constants.h"
 #include "common/Messages.h"
+#include "libCrypto/CommitPointPool.h"
 #include "libNetwork/P2PComm.h"
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
@@ -155,13 +156,18 @@ bool ConsensusLeader::ProcessMessageCommitCore(
         return false;
     }
 
-    // Check the signature
-    bool sig_valid = VerifyMessage(commit, offset, curr_offset - offset,
-                                   signature, backup_id);
-    if (sig_valid == false)
+    // Check the signature, unless PreProcessMessage already has
+    if (!TakePreVerified(action, backup_id, commit, offset,
+                         curr_offset + SIGNATURE_CHALLENGE_SIZE
+                             + SIGNATURE_RESPONSE_SIZE - offset))
     {
-        LOG_GENERAL(WARNING, "Invalid signature in commit message");
-        return false;
+        bool sig_valid = VerifyMessage(commit, offset, curr_offset - offset,
+                                       signature, backup_id);
+        if (sig_valid == false)
+        {
+            LOG_GENERAL(WARNING, "Invalid signature in commit message");
+            return false;
+        }
     }
 
     bool result = false;
@@ -678,31 +684,37 @@ bool ConsensusLeader::ProcessMessageResponseCore(
     Response tmp_response = Response(response, curr_offset);
     curr_offset += RESPONSE_SIZE;
 
-    if (MultiSig::VerifyResponse(tmp_response, m_challenge,
-                                 m_committee.at(backup_id).first,
-                                 m_commitPointMap.at(backup_id))
-        == false)
+    // Check the response and signature, unless PreProcessMessage already has
+    if (!TakePreVerified(action, backup_id, response, offset,
+                         curr_offset + SIGNATURE_CHALLENGE_SIZE
+                             + SIGNATURE_RESPONSE_SIZE - offset))
     {
-        LOG_GENERAL(WARNING, "Invalid response for this backup");
-        return false;
-    }
+        if (MultiSig::VerifyResponse(tmp_response, m_challenge,
+                                     m_committee.at(backup_id).first,
+                                     m_commitPointMap.at(backup_id))
+            == false)
+        {
+            LOG_GENERAL(WARNING, "Invalid response for this backup");
+            return false;
+        }
 
-    // 64-byte signature
-    // Signature signature(response, curr_offset);
-    Signature signature;
-    if (signature.Deserialize(response, curr_offset) != 0)
-    {
-        LOG_GENERAL(WARNING, "We failed to deserialize signature.");
-        return false;
-    }
+        // 64-byte signature
+        // Signature signature(response, curr_offset);
+        Signature signature;
+        if (signature.Deserialize(response, curr_offset) != 0)
+        {
+            LOG_GENERAL(WARNING, "We failed to deserialize signature.");
+            return false;
+        }
 
-    // Check the signature
-    bool sig_valid = VerifyMessage(response, offset, curr_offset - offset,
-                                   signature, backup_id);
-    if (sig_valid == false)
-    {
-        LOG_GENERAL(WARNING, "Invalid signature in response message");
-        return false;
+        // Check the signature
+        bool sig_valid = VerifyMessage(response, offset, curr_offset - offset,
+                                       signature, backup_id);
+        if (sig_valid == false)
+        {
+            LOG_GENERAL(WARNING, "Invalid signature in response message");
+            return false;
+        }
     }
 
     // Update internal state
@@ -760,7 +772,10 @@ bool ConsensusLeader::ProcessMessageResponseCore(
                 m_commitPoints.clear();
                 fill(m_commitMap.begin(), m_commitMap.end(), false);
 
-                // Add the leader to the commits
+                // Add the leader to the commits, with a fresh commit since
+                // answering a second challenge with the same secret leaks the key
+                CommitPointPool::GetInstance().Take(m_commitSecret,
+                                                    m_commitPoint);
                 m_commitMap.at(m_myID) = true;
                 m_commitPoints.emplace_back(*m_commitPoint);
                 m_commitPointMap.at(m_myID) = *m_commitPoint;
@@ -912,6 +927,25 @@ bool ConsensusLeader::GenerateCollectiveSigMessage(
     return true;
 }
 
+bool ConsensusLeader::TakePreVerified(Action action, uint16_t backup_id,
+                                      const vector<unsigned char>& msg,
+                                      unsigned int offset, unsigned int size)
+{
+    lock_guard<mutex> g(m_mutex);
+
+    auto it = m_preVerified.find(make_pair(action, backup_id));
+    if (it == m_preVerified.end())
+    {
+        return false;
+    }
+
+    bool match = (it->second.size() == size)
+        && equal(it->second.begin(), it->second.end(), msg.begin() + offset);
+    m_preVerified.erase(it);
+
+    return match;
+}
+
 bool ConsensusLeader::ProcessMessageFinalCommit(
     const vector<unsigned char>& finalcommit, unsigned int offset)
 {
@@ -959,8 +993,7 @@ ConsensusLeader::ConsensusLeader(
     m_nodeCommitFailureHandlerFunc = nodeCommitFailureHandlerFunc;
     m_shardCommitFailureHandlerFunc = shardCommitFailureHandlerFunc;
 
-    m_commitSecret.reset(new CommitSecret());
-    m_commitPoint.reset(new CommitPoint(*m_commitSecret));
+    CommitPointPool::GetInstance().Take(m_commitSecret, m_commitPoint);
 
     // Add the leader to the commits
     m_commitMap.at(m_myID) = true;
@@ -1108,6 +1141,128 @@ bool ConsensusLeader::ProcessMessage(const vector<unsigned char>& message,
     return result;
 }
 
+bool ConsensusLeader::PreProcessMessage(const vector<unsigned char>& message,
+                                        unsigned int offset,
+                                        [[gnu::unused]] const Peer& from)
+{
+    // Only the per-backup signatures of commits and responses are checked here.
+    // Anything that doesn't fit is left for ProcessMessage to check and report.
+
+    if (offset >= message.size())
+    {
+        return true;
+    }
+
+    Action action;
+    unsigned int body_size;
+
+    switch (message.at(offset))
+    {
+    case ConsensusMessageType::COMMIT:
+        action = PROCESS_COMMIT;
+        body_size = COMMIT_POINT_SIZE;
+        break;
+    case ConsensusMessageType::FINALCOMMIT:
+        action = PROCESS_FINALCOMMIT;
+        body_size = COMMIT_POINT_SIZE;
+        break;
+    case ConsensusMessageType::RESPONSE:
+        action = PROCESS_RESPONSE;
+        body_size = RESPONSE_SIZE;
+        break;
+    case ConsensusMessageType::FINALRESPONSE:
+        action = PROCESS_FINALRESPONSE;
+        body_size = RESPONSE_SIZE;
+        break;
+    default:
+        return true;
+    }
+
+    // Format: [4-byte consensus id] [32-byte blockhash] [2-byte backup id] [commit or response] [64-byte signature]
+
+    const unsigned int body_offset = offset + 1;
+    const unsigned int header_size
+        = sizeof(uint32_t) + BLOCK_HASH_SIZE + sizeof(uint16_t);
+    const unsigned int signed_size = header_size + body_size;
+
+    if (signed_size + SIGNATURE_CHALLENGE_SIZE + SIGNATURE_RESPONSE_SIZE
+        > message.size() - body_offset)
+    {
+        return true;
+    }
+
+    if (Serializable::GetNumber<uint32_t>(message, body_offset,
+                                          sizeof(uint32_t))
+            != m_consensusID
+        || !equal(m_blockHash.begin(), m_blockHash.end(),
+                  message.begin() + body_offset + sizeof(uint32_t)))
+    {
+        return true;
+    }
+
+    uint16_t backup_id = Serializable::GetNumber<uint16_t>(
+        message, body_offset + sizeof(uint32_t) + BLOCK_HASH_SIZE,
+        sizeof(uint16_t));
+    if (backup_id >= m_committee.size())
+    {
+        return true;
+    }
+
+    Signature signature;
+    if (signature.Deserialize(message, body_offset + signed_size) != 0)
+    {
+        return true;
+    }
+
+    if ((action == PROCESS_RESPONSE) || (action == PROCESS_FINALRESPONSE))
+    {
+        // The challenge and commit only change with the state, so a response
+        // checked against this snapshot is only used while the state holds
+        Challenge challenge;
+        CommitPoint commit_point;
+        {
+            lock_guard<mutex> g(m_mutex);
+
+            if (m_state
+                    != (action == PROCESS_RESPONSE ? CHALLENGE_DONE
+                                                   : FINALCHALLENGE_DONE)
+                || m_commitMap.at(backup_id) == false)
+            {
+                return true;
+            }
+
+            challenge = m_challenge;
+            commit_point = m_commitPointMap.at(backup_id);
+        }
+
+        if (MultiSig::VerifyResponse(
+                Response(message, body_offset + header_size), challenge,
+                m_committee.at(backup_id).first, commit_point)
+            == false)
+        {
+            LOG_GENERAL(WARNING, "Invalid response for this backup");
+            return false;
+        }
+    }
+
+    if (VerifyMessage(message, body_offset, signed_size, signature, backup_id)
+        == false)
+    {
+        LOG_GENERAL(WARNING,
+                    "Invalid signature in " << GetActionString(action)
+                                            << " message");
+        return false;
+    }
+
+    lock_guard<mutex> g(m_mutex);
+    m_preVerified[make_pair(action, backup_id)] = vector<unsigned char>(
+        message.begin() + body_offset,
+        message.begin() + body_offset + signed_size + SIGNATURE_CHALLENGE_SIZE
+            + SIGNATURE_RESPONSE_SIZE);
+
+    return true;
+}
+
 #define MAKE_LITERAL_PAIR(s)                                                   \
     {                                                                          \
         s, #s                                                                  \
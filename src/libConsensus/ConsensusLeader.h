@@ -20,6 +20,7 @@
 
 #include <deque>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -77,6 +78,10 @@ class ConsensusLeader : public ConsensusCommon
     std::vector<Response> m_responseDataMap;
     std::vector<Response> m_responseData;
 
+    // Messages already checked by PreProcessMessage, by action and backup id
+    std::map<std::pair<Action, uint16_t>, std::vector<unsigned char>>
+        m_preVerified;
+
     NodeCommitFailureHandlerFunc m_nodeCommitFailureHandlerFunc;
     ShardCommitFailureHandlerFunc m_shardCommitFailureHandlerFunc;
 
@@ -100,6 +105,9 @@ class ConsensusLeader : public ConsensusCommon
                                 unsigned int offset);
     bool GenerateCollectiveSigMessage(std::vector<unsigned char>& collectivesig,
                                       unsigned int offset);
+    bool TakePreVerified(Action action, uint16_t backup_id,
+                         const std::vector<unsigned char>& msg,
+                         unsigned int offset, unsigned int size);
     bool
     ProcessMessageFinalCommit(const std::vector<unsigned char>& finalcommit,
                               unsigned int offset);
@@ -136,6 +144,10 @@ public:
     bool ProcessMessage(const std::vector<unsigned char>& message,
                         unsigned int offset, const Peer& from);
 
+    /// Verifies the signature (and response) of a commit or response message ahead of ProcessMessage.
+    bool PreProcessMessage(const std::vector<unsigned char>& message,
+                           unsigned int offset, const Peer& from);
+
 private:
     static std::map<Action, std::string> ActionStrings;
     std::string GetActionString(Action action) const;
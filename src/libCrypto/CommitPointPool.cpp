@@ -0,0 +1,126 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+#include "CommitPointPool.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+CommitPointPool::CommitPointPool()
+    : m_capacity(COMMIT_POOL_SIZE)
+    , m_bailout(false)
+{
+    if (m_capacity == 0)
+    {
+        return;
+    }
+
+    // Make sure the curve outlives the refill thread
+    Schnorr::GetInstance();
+
+    m_thread = thread([this] { this->Refill(); });
+}
+
+CommitPointPool::~CommitPointPool()
+{
+    {
+        lock_guard<mutex> g(m_mutex);
+        m_bailout = true;
+    }
+    m_cvRefill.notify_all();
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+CommitPointPool& CommitPointPool::GetInstance()
+{
+    static CommitPointPool pool;
+    return pool;
+}
+
+CommitPointPool::Entry CommitPointPool::Generate()
+{
+    Entry entry;
+    entry.m_secret.reset(new CommitSecret());
+    entry.m_point.reset(new CommitPoint(*entry.m_secret));
+    return entry;
+}
+
+void CommitPointPool::Refill()
+{
+    unique_lock<mutex> g(m_mutex);
+
+    while (true)
+    {
+        m_cvRefill.wait(
+            g, [this] { return m_bailout || m_pool.size() < m_capacity; });
+
+        if (m_bailout)
+        {
+            return;
+        }
+
+        g.unlock();
+        Entry entry = Generate();
+        g.lock();
+
+        if (entry.m_secret->Initialized() && entry.m_point->Initialized())
+        {
+            m_pool.emplace_back(move(entry));
+        }
+    }
+}
+
+void CommitPointPool::Take(shared_ptr<CommitSecret>& secret,
+                           shared_ptr<CommitPoint>& point)
+{
+    Entry entry;
+
+    {
+        lock_guard<mutex> g(m_mutex);
+
+        if (!m_pool.empty())
+        {
+            entry = move(m_pool.front());
+            m_pool.pop_front();
+        }
+    }
+
+    if (entry.m_secret == nullptr)
+    {
+        if (m_capacity > 0)
+        {
+            LOG_GENERAL(INFO, "Commit pool empty, generating commit in place");
+        }
+        entry = Generate();
+    }
+    else
+    {
+        m_cvRefill.notify_one();
+    }
+
+    secret = move(entry.m_secret);
+    point = move(entry.m_point);
+}
+
+size_t CommitPointPool::Size()
+{
+    lock_guard<mutex> g(m_mutex);
+    return m_pool.size();
+}
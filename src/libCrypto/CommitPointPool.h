@@ -0,0 +1,68 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+#ifndef __COMMITPOINTPOOL_H__
+#define __COMMITPOINTPOOL_H__
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "MultiSig.h"
+
+/// Keeps a stock of fresh multisig commitments (secret and point), refilled by a background thread.
+/// Moves the scalar multiplication for a commitment off the consensus round trip.
+/// Every pair is handed out exactly once, and then forgotten by the pool.
+class CommitPointPool
+{
+    struct Entry
+    {
+        std::shared_ptr<CommitSecret> m_secret;
+        std::shared_ptr<CommitPoint> m_point;
+    };
+
+    const size_t m_capacity;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cvRefill;
+    std::deque<Entry> m_pool;
+    bool m_bailout;
+    std::thread m_thread;
+
+    CommitPointPool();
+    ~CommitPointPool();
+
+    // Singleton should not implement these
+    CommitPointPool(CommitPointPool const&) = delete;
+    void operator=(CommitPointPool const&) = delete;
+
+    static Entry Generate();
+    void Refill();
+
+public:
+    /// Returns the singleton CommitPointPool instance.
+    static CommitPointPool& GetInstance();
+
+    /// Hands out an unused commitment pair, generating one on the spot if the pool has run dry.
+    void Take(std::shared_ptr<CommitSecret>& secret,
+              std::shared_ptr<CommitPoint>& point);
+
+    /// Returns the number of pairs ready to be taken.
+    size_t Size();
+};
+
+#endif // __COMMITPOINTPOOL_H__
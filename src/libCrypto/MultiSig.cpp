@@ -14,12 +14,139 @@
 * and which include a reference to GPLv3 in their program files.
 **/
 
+#include <algorithm>
+#include <list>
+#include <mutex>
+
 #include "MultiSig.h"
 #include "Sha2.h"
 #include "libUtils/Logger.h"
 
 using namespace std;
 
+namespace
+{
+    // Enough for the DS committee and the shards verified within a DS epoch
+    const unsigned int COMMITTEE_CACHE_SIZE = 8;
+
+    /// Precomputed key material of one committee, shared read-only.
+    struct CommitteeKeyContext
+    {
+        vector<shared_ptr<EC_POINT>> m_keys;
+        vector<shared_ptr<EC_POINT>> m_negated;
+        shared_ptr<EC_POINT> m_sum;
+
+        bool Matches(const vector<PubKey>& committee, BN_CTX* ctx) const
+        {
+            if (committee.size() != m_keys.size())
+            {
+                return false;
+            }
+
+            // Affine points compare with a few BN_cmp, far cheaper than hashing the keys
+            const Curve& curve = Schnorr::GetInstance().GetCurve();
+            for (unsigned int i = 0; i < m_keys.size(); i++)
+            {
+                if (EC_POINT_cmp(curve.m_group.get(), m_keys.at(i).get(),
+                                 committee.at(i).m_P.get(), ctx)
+                    != 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    mutex g_mutexCommittees;
+    list<shared_ptr<const CommitteeKeyContext>> g_committees;
+
+    shared_ptr<const CommitteeKeyContext>
+    BuildCommitteeKeyContext(const vector<PubKey>& committee)
+    {
+        const Curve& curve = Schnorr::GetInstance().GetCurve();
+        BN_CTX* ctx = Schnorr::GetBNCtx();
+
+        auto context = make_shared<CommitteeKeyContext>();
+        context->m_sum.reset(EC_POINT_new(curve.m_group.get()),
+                             EC_POINT_clear_free);
+        if ((context->m_sum == nullptr)
+            || !EC_POINT_set_to_infinity(curve.m_group.get(),
+                                         context->m_sum.get()))
+        {
+            return nullptr;
+        }
+
+        vector<EC_POINT*> points;
+        for (const auto& pubkey : committee)
+        {
+            shared_ptr<EC_POINT> key(
+                EC_POINT_dup(pubkey.m_P.get(), curve.m_group.get()),
+                EC_POINT_clear_free);
+            shared_ptr<EC_POINT> negated(
+                EC_POINT_dup(pubkey.m_P.get(), curve.m_group.get()),
+                EC_POINT_clear_free);
+            if ((key == nullptr) || (negated == nullptr)
+                || !EC_POINT_add(curve.m_group.get(), context->m_sum.get(),
+                                 context->m_sum.get(), key.get(), ctx)
+                || !EC_POINT_invert(curve.m_group.get(), negated.get(), ctx))
+            {
+                return nullptr;
+            }
+            context->m_keys.emplace_back(key);
+            context->m_negated.emplace_back(negated);
+            points.emplace_back(key.get());
+            points.emplace_back(negated.get());
+        }
+
+        if (!EC_POINTs_make_affine(curve.m_group.get(), points.size(),
+                                   points.data(), ctx))
+        {
+            return nullptr;
+        }
+
+        return context;
+    }
+
+    shared_ptr<const CommitteeKeyContext>
+    GetCommitteeKeyContext(const vector<PubKey>& committee)
+    {
+        BN_CTX* ctx = Schnorr::GetBNCtx();
+
+        {
+            lock_guard<mutex> g(g_mutexCommittees);
+            for (auto it = g_committees.begin(); it != g_committees.end();
+                 it++)
+            {
+                if ((*it)->Matches(committee, ctx))
+                {
+                    g_committees.splice(g_committees.begin(), g_committees,
+                                        it);
+                    return g_committees.front();
+                }
+            }
+        }
+
+        LOG_GENERAL(INFO,
+                    "Caching aggregate key for committee of size "
+                        << committee.size());
+
+        auto context = BuildCommitteeKeyContext(committee);
+        if (context == nullptr)
+        {
+            return nullptr;
+        }
+
+        lock_guard<mutex> g(g_mutexCommittees);
+        g_committees.push_front(context);
+        if (g_committees.size() > COMMITTEE_CACHE_SIZE)
+        {
+            g_committees.pop_back();
+        }
+        return context;
+    }
+}
+
 CommitSecret::CommitSecret()
     : m_s(BN_new(), BN_clear_free)
     , m_initialized(false)
@@ -48,7 +175,9 @@ CommitSecret::CommitSecret()
             break;
         }
 
-        err = (BN_nnmod(m_s.get(), m_s.get(), curve.m_order.get(), NULL) == 0);
+        err = (BN_nnmod(m_s.get(), m_s.get(), curve.m_order.get(),
+                        Schnorr::GetBNCtx())
+               == 0);
         if (err)
         {
             LOG_GENERAL(WARNING, "Value to commit gen failed");
@@ -276,7 +405,7 @@ CommitPoint& CommitPoint::operator=(const CommitPoint& src)
 
 bool CommitPoint::operator==(const CommitPoint& r) const
 {
-    unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+    BN_CTX* ctx = Schnorr::GetBNCtx();
     if (ctx == nullptr)
     {
         LOG_GENERAL(WARNING, "Memory allocation failure");
@@ -286,7 +415,7 @@ bool CommitPoint::operator==(const CommitPoint& r) const
 
     return (m_initialized && r.m_initialized
             && (EC_POINT_cmp(Schnorr::GetInstance().GetCurve().m_group.get(),
-                             m_p.get(), r.m_p.get(), ctx.get())
+                             m_p.get(), r.m_p.get(), ctx)
                 == 0));
 }
 
@@ -478,7 +607,9 @@ void Challenge::Set(const CommitPoint& aggregatedCommit,
         return;
     }
 
-    if (BN_nnmod(m_c.get(), m_c.get(), curve.m_order.get(), NULL) == 0)
+    if (BN_nnmod(m_c.get(), m_c.get(), curve.m_order.get(),
+                 Schnorr::GetBNCtx())
+        == 0)
     {
         LOG_GENERAL(WARNING, "Could not reduce challenge modulo group order");
         return;
@@ -631,7 +762,7 @@ void Response::Set(const CommitSecret& secret, const Challenge& challenge,
     m_initialized = false;
 
     // Compute s = k - krpiv*c
-    unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+    BN_CTX* ctx = Schnorr::GetBNCtx();
     if (ctx == nullptr)
     {
         LOG_GENERAL(WARNING, "Memory allocation failure");
@@ -643,7 +774,7 @@ void Response::Set(const CommitSecret& secret, const Challenge& challenge,
 
     // kpriv*c
     if (BN_mod_mul(m_r.get(), challenge.m_c.get(), privkey.m_d.get(),
-                   curve.m_order.get(), ctx.get())
+                   curve.m_order.get(), ctx)
         == 0)
     {
         LOG_GENERAL(WARNING, "BIGNUM mod mul failed");
@@ -652,7 +783,7 @@ void Response::Set(const CommitSecret& secret, const Challenge& challenge,
 
     // k-kpriv*c
     if (BN_mod_sub(m_r.get(), secret.m_s.get(), m_r.get(), curve.m_order.get(),
-                   ctx.get())
+                   ctx)
         == 0)
     {
         LOG_GENERAL(WARNING, "BIGNUM mod add failed");
@@ -691,12 +822,13 @@ shared_ptr<PubKey> MultiSig::AggregatePubKeys(const vector<PubKey>& pubkeys)
         // throw exception();
         return nullptr;
     }
+    aggregatedPubkey->m_hasCompressed = false;
 
     for (unsigned int i = 1; i < pubkeys.size(); i++)
     {
         if (EC_POINT_add(curve.m_group.get(), aggregatedPubkey->m_P.get(),
                          aggregatedPubkey->m_P.get(), pubkeys.at(i).m_P.get(),
-                         NULL)
+                         Schnorr::GetBNCtx())
             == 0)
         {
             LOG_GENERAL(WARNING, "Pubkey aggregation failed");
@@ -707,6 +839,71 @@ shared_ptr<PubKey> MultiSig::AggregatePubKeys(const vector<PubKey>& pubkeys)
     return aggregatedPubkey;
 }
 
+shared_ptr<PubKey> MultiSig::AggregatePubKeys(const vector<PubKey>& committee,
+                                              const vector<bool>& bitmap)
+{
+    if (committee.size() != bitmap.size())
+    {
+        LOG_GENERAL(WARNING,
+                    "Mismatch: committee size = " << committee.size()
+                                                  << ", bitmap size = "
+                                                  << bitmap.size());
+        return nullptr;
+    }
+
+    const unsigned int present = count(bitmap.begin(), bitmap.end(), true);
+    if (present == 0)
+    {
+        LOG_GENERAL(WARNING, "Empty list of public keys");
+        return nullptr;
+    }
+
+    // Summing the signers directly is cheaper when most of them are absent
+    if (2 * present < committee.size())
+    {
+        vector<PubKey> pubkeys;
+        for (unsigned int i = 0; i < committee.size(); i++)
+        {
+            if (bitmap.at(i))
+            {
+                pubkeys.emplace_back(committee.at(i));
+            }
+        }
+        return AggregatePubKeys(pubkeys);
+    }
+
+    auto context = GetCommitteeKeyContext(committee);
+    if (context == nullptr)
+    {
+        LOG_GENERAL(WARNING, "Committee key setup failed");
+        return nullptr;
+    }
+
+    const Curve& curve = Schnorr::GetInstance().GetCurve();
+    shared_ptr<PubKey> aggregatedPubkey(new PubKey(committee.at(0)));
+    aggregatedPubkey->m_hasCompressed = false;
+    if (!EC_POINT_copy(aggregatedPubkey->m_P.get(), context->m_sum.get()))
+    {
+        LOG_GENERAL(WARNING, "Pubkey aggregation failed");
+        return nullptr;
+    }
+
+    for (unsigned int i = 0; i < bitmap.size(); i++)
+    {
+        if (!bitmap.at(i)
+            && !EC_POINT_add(curve.m_group.get(), aggregatedPubkey->m_P.get(),
+                             aggregatedPubkey->m_P.get(),
+                             context->m_negated.at(i).get(),
+                             Schnorr::GetBNCtx()))
+        {
+            LOG_GENERAL(WARNING, "Pubkey aggregation failed");
+            return nullptr;
+        }
+    }
+
+    return aggregatedPubkey;
+}
+
 shared_ptr<CommitPoint>
 MultiSig::AggregateCommits(const vector<CommitPoint>& commitPoints)
 {
@@ -761,7 +958,7 @@ MultiSig::AggregateResponses(const vector<Response>& responses)
         return nullptr;
     }
 
-    unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+    BN_CTX* ctx = Schnorr::GetBNCtx();
     if (ctx == nullptr)
     {
         LOG_GENERAL(WARNING, "Memory allocation failure");
@@ -773,7 +970,7 @@ MultiSig::AggregateResponses(const vector<Response>& responses)
     {
         if (BN_mod_add(aggregatedResponse->m_r.get(),
                        aggregatedResponse->m_r.get(), responses.at(i).m_r.get(),
-                       curve.m_order.get(), ctx.get())
+                       curve.m_order.get(), ctx)
             == 0)
         {
             LOG_GENERAL(WARNING, "Response aggregation failed");
@@ -946,7 +1143,7 @@ bool MultiSig::VerifyResponse(const Response& response,
         // Regenerate the commitmment part of the signature
         unique_ptr<EC_POINT, void (*)(EC_POINT*)> Q(
             EC_POINT_new(curve.m_group.get()), EC_POINT_clear_free);
-        unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+        BN_CTX* ctx = Schnorr::GetBNCtx();
 
         if ((ctx != nullptr) && (Q != nullptr))
         {
@@ -962,7 +1159,7 @@ bool MultiSig::VerifyResponse(const Response& response,
             // 2. Compute Q = sG + r*kpub
             err = (EC_POINT_mul(curve.m_group.get(), Q.get(),
                                 response.m_r.get(), pubkey.m_P.get(),
-                                challenge.m_c.get(), ctx.get())
+                                challenge.m_c.get(), ctx)
                    == 0);
             if (err)
             {
@@ -972,7 +1169,7 @@ bool MultiSig::VerifyResponse(const Response& response,
 
             // 3. Q == commitPoint
             err = (EC_POINT_cmp(curve.m_group.get(), Q.get(),
-                                commitPoint.m_p.get(), ctx.get())
+                                commitPoint.m_p.get(), ctx)
                    != 0);
             if (err)
             {
@@ -217,6 +217,12 @@ public:
     static std::shared_ptr<PubKey>
     AggregatePubKeys(const std::vector<PubKey>& pubkeys);
 
+    /// Aggregates committee[i] for every i set in bitmap.
+    /// The full sum of each recently seen committee is cached, so only the absent keys get subtracted.
+    static std::shared_ptr<PubKey>
+    AggregatePubKeys(const std::vector<PubKey>& committee,
+                     const std::vector<bool>& bitmap);
+
     /// Aggregates the received commitments for the multisignature aggregator.
     static std::shared_ptr<CommitPoint>
     AggregateCommits(const std::vector<CommitPoint>& commitPoints);
@@ -0,0 +1,235 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <algorithm>
+#include <cstring>
+
+#include "PubKeyCache.h"
+#include "Schnorr.h"
+#include "Sha2.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+const unsigned int STATS_LOG_SECONDS = 300;
+
+// Rough heap footprint of one entry besides the Entry itself:
+// list and hash nodes, plus the EC_POINT with its three coordinates
+const size_t ENTRY_OVERHEAD_BYTES = 64 + 3 * 64 + 64;
+
+namespace
+{
+    Address ComputeAddress(const PubKeyCache::Key& key)
+    {
+        SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+        SHA2<HASH_TYPE::HASH_VARIANT_256>::Digest output;
+        sha2.Update(key);
+        sha2.Finalize(output);
+
+        Address address;
+        copy(output.end() - ACC_ADDR_SIZE, output.end(),
+             address.asArray().begin());
+        return address;
+    }
+}
+
+size_t PubKeyCache::KeyHash::operator()(const Key& key) const
+{
+    // Byte 0 is only the parity of y; the x coordinate is already uniform
+    size_t h;
+    memcpy(&h, key.data() + 1, sizeof(h));
+    return h;
+}
+
+PubKeyCache::PubKeyCache()
+    : m_shardCapacity(max(PUBKEY_CACHE_SIZE / NUM_SHARDS, 1u))
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+    , m_lastLog(chrono::steady_clock::now())
+{
+}
+
+PubKeyCache::~PubKeyCache() {}
+
+PubKeyCache& PubKeyCache::GetInstance()
+{
+    static PubKeyCache cache;
+    return cache;
+}
+
+PubKeyCache::Shard& PubKeyCache::ShardOf(const Key& key)
+{
+    return m_shards[key[PUB_KEY_SIZE - 1] % NUM_SHARDS];
+}
+
+bool PubKeyCache::Lookup(const Key& key, bool need_point, Entry& entry)
+{
+    Shard& shard = ShardOf(key);
+    bool cached = false;
+
+    {
+        lock_guard<mutex> g(shard.m_mutex);
+        auto it = shard.m_index.find(key);
+        if (it != shard.m_index.end())
+        {
+            shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, it->second);
+            entry = *it->second;
+            cached = true;
+
+            if (!need_point || (entry.m_point != nullptr))
+            {
+                m_hits++;
+                return true;
+            }
+        }
+    }
+
+    m_misses++;
+    MaybeLogStats();
+
+    // Decode and hash outside the lock; these are what the cache saves
+    if (!cached)
+    {
+        entry.m_key = key;
+        entry.m_address = ComputeAddress(key);
+    }
+
+    if (need_point)
+    {
+        const Curve& curve = Schnorr::GetInstance().GetCurve();
+        shared_ptr<EC_POINT> point(EC_POINT_new(curve.m_group.get()),
+                                   EC_POINT_clear_free);
+        if ((point == nullptr)
+            || (EC_POINT_oct2point(curve.m_group.get(), point.get(),
+                                   key.data(), PUB_KEY_SIZE,
+                                   Schnorr::GetBNCtx())
+                != 1))
+        {
+            return false;
+        }
+        entry.m_point = point;
+    }
+
+    lock_guard<mutex> g(shard.m_mutex);
+    auto it = shard.m_index.find(key);
+    if (it != shard.m_index.end())
+    {
+        // Another thread got here first, or only the address was cached so far
+        if (it->second->m_point == nullptr)
+        {
+            it->second->m_point = entry.m_point;
+        }
+        return true;
+    }
+
+    shard.m_lru.push_front(entry);
+    shard.m_index.emplace(key, shard.m_lru.begin());
+
+    if (shard.m_lru.size() > m_shardCapacity)
+    {
+        shard.m_index.erase(shard.m_lru.back().m_key);
+        shard.m_lru.pop_back();
+        m_evictions++;
+    }
+
+    return true;
+}
+
+shared_ptr<const EC_POINT>
+PubKeyCache::GetPoint(const vector<unsigned char>& src, unsigned int offset)
+{
+    if (offset + PUB_KEY_SIZE > src.size())
+    {
+        LOG_GENERAL(WARNING,
+                    "Unable to get public key from stream with available size "
+                        << src.size() - offset);
+        return nullptr;
+    }
+
+    Key key;
+    copy(src.begin() + offset, src.begin() + offset + PUB_KEY_SIZE,
+         key.begin());
+
+    Entry entry;
+    if (!Lookup(key, true, entry))
+    {
+        return nullptr;
+    }
+    return entry.m_point;
+}
+
+Address PubKeyCache::GetAddress(const vector<unsigned char>& src,
+                                unsigned int offset)
+{
+    if (offset + PUB_KEY_SIZE > src.size())
+    {
+        return Address();
+    }
+
+    Key key;
+    copy(src.begin() + offset, src.begin() + offset + PUB_KEY_SIZE,
+         key.begin());
+    return GetAddress(key);
+}
+
+Address PubKeyCache::GetAddress(const Key& key)
+{
+    // Lookup cannot fail without decoding, so any 33 bytes get an address
+    Entry entry;
+    Lookup(key, false, entry);
+    return entry.m_address;
+}
+
+PubKeyCache::Stats PubKeyCache::GetStats()
+{
+    Stats stats{m_hits, m_misses, m_evictions, 0, 0};
+
+    for (auto& shard : m_shards)
+    {
+        lock_guard<mutex> g(shard.m_mutex);
+        stats.m_entries += shard.m_lru.size();
+    }
+    stats.m_memoryBytes
+        = stats.m_entries * (sizeof(Entry) + ENTRY_OVERHEAD_BYTES);
+
+    return stats;
+}
+
+void PubKeyCache::MaybeLogStats()
+{
+    {
+        unique_lock<mutex> g(m_mutexLog, try_to_lock);
+        if (!g.owns_lock()
+            || (chrono::steady_clock::now() - m_lastLog
+                < chrono::seconds(STATS_LOG_SECONDS)))
+        {
+            return;
+        }
+        m_lastLog = chrono::steady_clock::now();
+    }
+
+    Stats stats = GetStats();
+    uint64_t lookups = stats.m_hits + stats.m_misses;
+
+    LOG_GENERAL(INFO,
+                "PubKeyCache entries: "
+                    << stats.m_entries << " (~" << stats.m_memoryBytes / 1024
+                    << " KB) hits: " << stats.m_hits
+                    << " misses: " << stats.m_misses
+                    << " evictions: " << stats.m_evictions << " hit rate: "
+                    << (lookups ? 100 * stats.m_hits / lookups : 0) << "%");
+}
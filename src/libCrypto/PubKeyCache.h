@@ -0,0 +1,116 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#ifndef __PUBKEYCACHE_H__
+#define __PUBKEYCACHE_H__
+
+#include <openssl/ec.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/Constants.h"
+#include "libData/AccountData/Address.h"
+
+/// Bounded, concurrent LRU from compressed public key bytes to the decoded curve point and the derived address.
+/// Saves the square root of point decompression and the address hash for keys that are seen repeatedly.
+class PubKeyCache
+{
+public:
+    using Key = std::array<unsigned char, PUB_KEY_SIZE>;
+
+    /// Snapshot of the cache counters.
+    struct Stats
+    {
+        uint64_t m_hits;
+        uint64_t m_misses;
+        uint64_t m_evictions;
+        size_t m_entries;
+        size_t m_memoryBytes;
+    };
+
+private:
+    static const unsigned int NUM_SHARDS = 16;
+
+    /// m_point stays empty until a caller needs the decoded point.
+    struct Entry
+    {
+        Key m_key;
+        std::shared_ptr<const EC_POINT> m_point;
+        Address m_address;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    /// Each shard keeps its own recency list, most recently used first.
+    struct Shard
+    {
+        std::mutex m_mutex;
+        std::list<Entry> m_lru;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+    };
+
+    const size_t m_shardCapacity;
+    std::array<Shard, NUM_SHARDS> m_shards;
+
+    std::atomic<uint64_t> m_hits;
+    std::atomic<uint64_t> m_misses;
+    std::atomic<uint64_t> m_evictions;
+
+    std::mutex m_mutexLog;
+    std::chrono::steady_clock::time_point m_lastLog;
+
+    PubKeyCache();
+    ~PubKeyCache();
+
+    // Singleton should not implement these
+    PubKeyCache(PubKeyCache const&) = delete;
+    void operator=(PubKeyCache const&) = delete;
+
+    Shard& ShardOf(const Key& key);
+    bool Lookup(const Key& key, bool need_point, Entry& entry);
+    void MaybeLogStats();
+
+public:
+    /// Returns the singleton PubKeyCache instance.
+    static PubKeyCache& GetInstance();
+
+    /// Returns the point encoded by the compressed key at src[offset], or nullptr if it is not a valid key.
+    /// The point is shared with the cache and must not be modified.
+    std::shared_ptr<const EC_POINT>
+    GetPoint(const std::vector<unsigned char>& src, unsigned int offset);
+
+    /// Returns the address of the compressed key at src[offset] (last ACC_ADDR_SIZE bytes of its SHA-256).
+    Address GetAddress(const std::vector<unsigned char>& src,
+                       unsigned int offset);
+
+    /// Returns the address of the compressed key, hashing it on a miss without decoding the point.
+    Address GetAddress(const Key& key);
+
+    /// Returns the current hit, miss and size counters.
+    Stats GetStats();
+};
+
+#endif // __PUBKEYCACHE_H__
@@ -24,16 +24,18 @@
 #include <openssl/err.h>
 #include <openssl/obj_mac.h>
 
+#include <algorithm>
 #include <array>
+#include <condition_variable>
+#include <thread>
 
+#include "PubKeyCache.h"
 #include "Schnorr.h"
 #include "libUtils/Logger.h"
+#include "libUtils/ThreadPool.h"
 
 using namespace std;
 
-std::mutex BIGNUMSerialize::m_mutexBIGNUM;
-std::mutex ECPOINTSerialize::m_mutexECPOINT;
-
 Curve::Curve()
     : m_group(EC_GROUP_new_by_curve_name(NID_secp256k1), EC_GROUP_clear_free)
     , m_order(BN_new(), BN_clear_free)
@@ -71,8 +73,6 @@ shared_ptr<BIGNUM> BIGNUMSerialize::GetNumber(const vector<unsigned char>& src,
                                          << __FUNCTION__ << ")");
     }
 
-    lock_guard<mutex> g(m_mutexBIGNUM);
-
     if (offset + size <= src.size())
     {
         BIGNUM* ret = BN_bin2bn(src.data() + offset, size, NULL);
@@ -102,8 +102,6 @@ void BIGNUMSerialize::SetNumber(vector<unsigned char>& dst, unsigned int offset,
                                          << __FUNCTION__ << ")");
     }
 
-    lock_guard<mutex> g(m_mutexBIGNUM);
-
     const int actual_bn_size = BN_num_bytes(value.get());
 
     //if (actual_bn_size > 0)
@@ -148,11 +146,10 @@ ECPOINTSerialize::GetNumber(const vector<unsigned char>& src,
                             unsigned int offset, unsigned int size)
 {
     shared_ptr<BIGNUM> bnvalue = BIGNUMSerialize::GetNumber(src, offset, size);
-    lock_guard<mutex> g(m_mutexECPOINT);
 
     if (bnvalue != nullptr)
     {
-        unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+        BN_CTX* ctx = Schnorr::GetBNCtx();
         if (ctx == nullptr)
         {
             LOG_GENERAL(WARNING, "Memory allocation failure");
@@ -161,7 +158,7 @@ ECPOINTSerialize::GetNumber(const vector<unsigned char>& src,
 
         EC_POINT* ret
             = EC_POINT_bn2point(Schnorr::GetInstance().GetCurve().m_group.get(),
-                                bnvalue.get(), NULL, ctx.get());
+                                bnvalue.get(), NULL, ctx);
         if (ret != NULL)
         {
             return shared_ptr<EC_POINT>(ret, EC_POINT_clear_free);
@@ -176,9 +173,7 @@ void ECPOINTSerialize::SetNumber(vector<unsigned char>& dst,
 {
     shared_ptr<BIGNUM> bnvalue;
     {
-        std::lock_guard<mutex> g(m_mutexECPOINT);
-
-        unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+        BN_CTX* ctx = Schnorr::GetBNCtx();
         if (ctx == nullptr)
         {
             LOG_GENERAL(WARNING, "Memory allocation failure");
@@ -188,7 +183,7 @@ void ECPOINTSerialize::SetNumber(vector<unsigned char>& dst,
         bnvalue.reset(
             EC_POINT_point2bn(Schnorr::GetInstance().GetCurve().m_group.get(),
                               value.get(), POINT_CONVERSION_COMPRESSED, NULL,
-                              ctx.get()),
+                              ctx),
             BN_clear_free);
         if (bnvalue == nullptr)
         {
@@ -320,6 +315,7 @@ PubKey::PubKey()
     : m_P(EC_POINT_new(Schnorr::GetInstance().GetCurve().m_group.get()),
           EC_POINT_clear_free)
     , m_initialized(false)
+    , m_hasCompressed(false)
 {
     if (m_P == nullptr)
     {
@@ -332,6 +328,7 @@ PubKey::PubKey(const PrivKey& privkey)
     : m_P(EC_POINT_new(Schnorr::GetInstance().GetCurve().m_group.get()),
           EC_POINT_clear_free)
     , m_initialized(false)
+    , m_hasCompressed(false)
 {
     if (m_P == nullptr)
     {
@@ -356,7 +353,7 @@ PubKey::PubKey(const PrivKey& privkey)
         }
 
         if (EC_POINT_mul(curve.m_group.get(), m_P.get(), privkey.m_d.get(),
-                         NULL, NULL, NULL)
+                         NULL, NULL, Schnorr::GetBNCtx())
             == 0)
         {
             LOG_GENERAL(WARNING, "Public key generation failed");
@@ -368,6 +365,8 @@ PubKey::PubKey(const PrivKey& privkey)
 }
 
 PubKey::PubKey(const vector<unsigned char>& src, unsigned int offset)
+    : m_initialized(false)
+    , m_hasCompressed(false)
 {
     if (Deserialize(src, offset) != 0)
     {
@@ -379,6 +378,8 @@ PubKey::PubKey(const PubKey& src)
     : m_P(EC_POINT_new(Schnorr::GetInstance().GetCurve().m_group.get()),
           EC_POINT_clear_free)
     , m_initialized(false)
+    , m_compressed(src.m_compressed)
+    , m_hasCompressed(false)
 {
     if (m_P == nullptr)
     {
@@ -399,6 +400,7 @@ PubKey::PubKey(const PubKey& src)
         else
         {
             m_initialized = true;
+            m_hasCompressed = src.m_hasCompressed;
         }
     }
 }
@@ -410,7 +412,15 @@ bool PubKey::Initialized() const { return m_initialized; }
 unsigned int PubKey::Serialize(vector<unsigned char>& dst,
                                unsigned int offset) const
 {
-    if (m_initialized)
+    if (m_initialized && m_hasCompressed)
+    {
+        if (dst.size() < offset + PUB_KEY_SIZE)
+        {
+            dst.resize(offset + PUB_KEY_SIZE);
+        }
+        copy(m_compressed.begin(), m_compressed.end(), dst.begin() + offset);
+    }
+    else if (m_initialized)
     {
         ECPOINTSerialize::SetNumber(dst, offset, PUB_KEY_SIZE, m_P);
     }
@@ -424,14 +434,28 @@ int PubKey::Deserialize(const vector<unsigned char>& src, unsigned int offset)
 
     try
     {
-        m_P = ECPOINTSerialize::GetNumber(src, offset, PUB_KEY_SIZE);
-        if (m_P == nullptr)
+        // The decoded point is shared through the cache, so keep a private copy
+        shared_ptr<const EC_POINT> point
+            = PubKeyCache::GetInstance().GetPoint(src, offset);
+        if (point != nullptr)
+        {
+            const Curve& curve = Schnorr::GetInstance().GetCurve();
+            m_P.reset(EC_POINT_dup(point.get(), curve.m_group.get()),
+                      EC_POINT_clear_free);
+        }
+
+        if ((point == nullptr) || (m_P == nullptr))
         {
             LOG_GENERAL(WARNING, "Deserialization failure");
             m_initialized = false;
+            m_hasCompressed = false;
         }
         else
         {
+            // The cache only decodes canonical encodings, so these are the bytes Serialize would write
+            copy(src.begin() + offset, src.begin() + offset + PUB_KEY_SIZE,
+                 m_compressed.begin());
+            m_hasCompressed = true;
             m_initialized = true;
         }
     }
@@ -447,12 +471,14 @@ int PubKey::Deserialize(const vector<unsigned char>& src, unsigned int offset)
 PubKey& PubKey::operator=(const PubKey& src)
 {
     m_initialized = (EC_POINT_copy(m_P.get(), src.m_P.get()) == 1);
+    m_compressed = src.m_compressed;
+    m_hasCompressed = m_initialized && src.m_hasCompressed;
     return *this;
 }
 
 bool PubKey::operator<(const PubKey& r) const
 {
-    unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+    BN_CTX* ctx = Schnorr::GetBNCtx();
     if (ctx == nullptr)
     {
         LOG_GENERAL(WARNING, "Memory allocation failure");
@@ -463,12 +489,12 @@ bool PubKey::operator<(const PubKey& r) const
     shared_ptr<BIGNUM> lhs_bnvalue(
         EC_POINT_point2bn(Schnorr::GetInstance().GetCurve().m_group.get(),
                           m_P.get(), POINT_CONVERSION_COMPRESSED, NULL,
-                          ctx.get()),
+                          ctx),
         BN_clear_free);
     shared_ptr<BIGNUM> rhs_bnvalue(
         EC_POINT_point2bn(Schnorr::GetInstance().GetCurve().m_group.get(),
                           r.m_P.get(), POINT_CONVERSION_COMPRESSED, NULL,
-                          ctx.get()),
+                          ctx),
         BN_clear_free);
 
     return (m_initialized && r.m_initialized
@@ -477,7 +503,7 @@ bool PubKey::operator<(const PubKey& r) const
 
 bool PubKey::operator>(const PubKey& r) const
 {
-    unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+    BN_CTX* ctx = Schnorr::GetBNCtx();
     if (ctx == nullptr)
     {
         LOG_GENERAL(WARNING, "Memory allocation failure");
@@ -488,12 +514,12 @@ bool PubKey::operator>(const PubKey& r) const
     shared_ptr<BIGNUM> lhs_bnvalue(
         EC_POINT_point2bn(Schnorr::GetInstance().GetCurve().m_group.get(),
                           m_P.get(), POINT_CONVERSION_COMPRESSED, NULL,
-                          ctx.get()),
+                          ctx),
         BN_clear_free);
     shared_ptr<BIGNUM> rhs_bnvalue(
         EC_POINT_point2bn(Schnorr::GetInstance().GetCurve().m_group.get(),
                           r.m_P.get(), POINT_CONVERSION_COMPRESSED, NULL,
-                          ctx.get()),
+                          ctx),
         BN_clear_free);
 
     return (m_initialized && r.m_initialized
@@ -502,7 +528,7 @@ bool PubKey::operator>(const PubKey& r) const
 
 bool PubKey::operator==(const PubKey& r) const
 {
-    unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+    BN_CTX* ctx = Schnorr::GetBNCtx();
     if (ctx == nullptr)
     {
         LOG_GENERAL(WARNING, "Memory allocation failure");
@@ -512,7 +538,7 @@ bool PubKey::operator==(const PubKey& r) const
 
     return (m_initialized && r.m_initialized
             && (EC_POINT_cmp(Schnorr::GetInstance().GetCurve().m_group.get(),
-                             m_P.get(), r.m_P.get(), ctx.get())
+                             m_P.get(), r.m_P.get(), ctx)
                 == 0));
 }
 
@@ -637,7 +663,18 @@ bool Signature::operator==(const Signature& r) const
                 && (BN_cmp(m_s.get(), r.m_s.get()) == 0)));
 }
 
-Schnorr::Schnorr() {}
+namespace
+{
+    // Smaller batches are not worth handing over to other threads
+    const unsigned int BATCH_VERIFY_MIN_CHUNK = 16;
+}
+
+Schnorr::Schnorr()
+    : m_verifyPool(new ThreadPool(
+          max(thread::hardware_concurrency(), (unsigned int)2) - 1,
+          "SchnorrVerify"))
+{
+}
 
 Schnorr::~Schnorr() {}
 
@@ -649,10 +686,17 @@ Schnorr& Schnorr::GetInstance()
 
 const Curve& Schnorr::GetCurve() const { return m_curve; }
 
+BN_CTX* Schnorr::GetBNCtx()
+{
+    // Lives as long as its thread; BN_CTX_start/end keep nested users apart
+    thread_local unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(),
+                                                            BN_CTX_free);
+    return ctx.get();
+}
+
 pair<PrivKey, PubKey> Schnorr::GenKeyPair()
 {
     // LOG_MARKER();
-    lock_guard<mutex> g(m_mutexSchnorr);
 
     PrivKey privkey;
     PubKey pubkey(privkey);
@@ -671,7 +715,6 @@ bool Schnorr::Sign(const vector<unsigned char>& message, unsigned int offset,
                    const PubKey& pubkey, Signature& result)
 {
     // LOG_MARKER();
-    lock_guard<mutex> g(m_mutexSchnorr);
 
     // Initial checks
 
@@ -725,7 +768,7 @@ bool Schnorr::Sign(const vector<unsigned char>& message, unsigned int offset,
     unique_ptr<BIGNUM, void (*)(BIGNUM*)> k(BN_new(), BN_clear_free);
     unique_ptr<EC_POINT, void (*)(EC_POINT*)> Q(
         EC_POINT_new(m_curve.m_group.get()), EC_POINT_clear_free);
-    unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+    BN_CTX* ctx = Schnorr::GetBNCtx();
 
     if ((k != nullptr) && (ctx != nullptr) && (Q != nullptr))
     {
@@ -751,7 +794,7 @@ bool Schnorr::Sign(const vector<unsigned char>& message, unsigned int offset,
 
             // 2. Compute the commitment Q = kG, where G is the base point
             err = (EC_POINT_mul(m_curve.m_group.get(), Q.get(), k.get(), NULL,
-                                NULL, NULL)
+                                NULL, ctx)
                    == 0);
             if (err)
             {
@@ -764,7 +807,7 @@ bool Schnorr::Sign(const vector<unsigned char>& message, unsigned int offset,
             // Convert the committment to octets first
             err = (EC_POINT_point2oct(m_curve.m_group.get(), Q.get(),
                                       POINT_CONVERSION_COMPRESSED, buf.data(),
-                                      PUBKEY_COMPRESSED_SIZE_BYTES, NULL)
+                                      PUBKEY_COMPRESSED_SIZE_BYTES, ctx)
                    != PUBKEY_COMPRESSED_SIZE_BYTES);
             if (err)
             {
@@ -781,7 +824,7 @@ bool Schnorr::Sign(const vector<unsigned char>& message, unsigned int offset,
             // Convert the public key to octets
             err = (EC_POINT_point2oct(m_curve.m_group.get(), pubkey.m_P.get(),
                                       POINT_CONVERSION_COMPRESSED, buf.data(),
-                                      PUBKEY_COMPRESSED_SIZE_BYTES, NULL)
+                                      PUBKEY_COMPRESSED_SIZE_BYTES, ctx)
                    != PUBKEY_COMPRESSED_SIZE_BYTES);
             if (err)
             {
@@ -806,7 +849,7 @@ bool Schnorr::Sign(const vector<unsigned char>& message, unsigned int offset,
             }
 
             err = (BN_nnmod(result.m_r.get(), result.m_r.get(),
-                            m_curve.m_order.get(), NULL)
+                            m_curve.m_order.get(), ctx)
                    == 0);
             if (err)
             {
@@ -818,7 +861,7 @@ bool Schnorr::Sign(const vector<unsigned char>& message, unsigned int offset,
             // 4.1 r*kpriv
             err = (BN_mod_mul(result.m_s.get(), result.m_r.get(),
                               privkey.m_d.get(), m_curve.m_order.get(),
-                              ctx.get())
+                              ctx)
                    == 0);
             if (err)
             {
@@ -828,7 +871,7 @@ bool Schnorr::Sign(const vector<unsigned char>& message, unsigned int offset,
 
             // 4.2 k-r*kpriv
             err = (BN_mod_sub(result.m_s.get(), k.get(), result.m_s.get(),
-                              m_curve.m_order.get(), ctx.get())
+                              m_curve.m_order.get(), ctx)
                    == 0);
             if (err)
             {
@@ -869,7 +912,6 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
                      const PubKey& pubkey)
 {
     // LOG_MARKER();
-    lock_guard<mutex> g(m_mutexSchnorr);
 
     // Initial checks
 
@@ -919,7 +961,7 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
                                                               BN_clear_free);
         unique_ptr<EC_POINT, void (*)(EC_POINT*)> Q(
             EC_POINT_new(m_curve.m_group.get()), EC_POINT_clear_free);
-        unique_ptr<BN_CTX, void (*)(BN_CTX*)> ctx(BN_CTX_new(), BN_CTX_free);
+        BN_CTX* ctx = Schnorr::GetBNCtx();
 
         if ((challenge_built != nullptr) && (ctx != nullptr) && (Q != nullptr))
         {
@@ -947,7 +989,7 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
             // 2. Compute Q = sG + r*kpub
             err2 = (EC_POINT_mul(m_curve.m_group.get(), Q.get(),
                                  toverify.m_s.get(), pubkey.m_P.get(),
-                                 toverify.m_r.get(), ctx.get())
+                                 toverify.m_r.get(), ctx)
                     == 0);
             err = err || err2;
             if (err2)
@@ -969,7 +1011,7 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
             // 4.1 Convert the committment to octets first
             err2 = (EC_POINT_point2oct(m_curve.m_group.get(), Q.get(),
                                        POINT_CONVERSION_COMPRESSED, buf.data(),
-                                       PUBKEY_COMPRESSED_SIZE_BYTES, NULL)
+                                       PUBKEY_COMPRESSED_SIZE_BYTES, ctx)
                     != PUBKEY_COMPRESSED_SIZE_BYTES);
             err = err || err2;
             if (err2)
@@ -987,7 +1029,7 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
             // 4.2 Convert the public key to octets
             err2 = (EC_POINT_point2oct(m_curve.m_group.get(), pubkey.m_P.get(),
                                        POINT_CONVERSION_COMPRESSED, buf.data(),
-                                       PUBKEY_COMPRESSED_SIZE_BYTES, NULL)
+                                       PUBKEY_COMPRESSED_SIZE_BYTES, ctx)
                     != PUBKEY_COMPRESSED_SIZE_BYTES);
             err = err || err2;
             if (err2)
@@ -1015,7 +1057,7 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
             }
 
             err2 = (BN_nnmod(challenge_built.get(), challenge_built.get(),
-                             m_curve.m_order.get(), NULL)
+                             m_curve.m_order.get(), ctx)
                     == 0);
             err = err || err2;
             if (err2)
@@ -1042,10 +1084,73 @@ bool Schnorr::Verify(const vector<unsigned char>& message, unsigned int offset,
     }
 }
 
+bool Schnorr::BatchVerify(const vector<SignedMessageRef>& batch,
+                          vector<bool>& results)
+{
+    // Each signature commits to its challenge r = H(Q, P, m) rather than to Q,
+    // so Q = sG + rP has to be rebuilt and hashed per entry and the entries
+    // cannot be folded into a single multi-scalar check. Instead, the batch
+    // is cut into chunks that are verified concurrently.
+
+    const unsigned int count = batch.size();
+    vector<unsigned char> valid(count, 0);
+
+    auto verifyRange = [this, &batch, &valid](unsigned int begin,
+                                              unsigned int end) {
+        for (unsigned int i = begin; i < end; i++)
+        {
+            const SignedMessageRef& entry = batch.at(i);
+            valid.at(i) = Verify(entry.m_message, entry.m_offset, entry.m_size,
+                                 entry.m_signature, entry.m_pubkey);
+        }
+    };
+
+    const unsigned int numWorkers = m_verifyPool->GetThreads().size() + 1;
+    const unsigned int chunkSize = max(
+        BATCH_VERIFY_MIN_CHUNK, (count + numWorkers - 1) / numWorkers);
+
+    mutex mutexPending;
+    condition_variable cvPending;
+    unsigned int pending = 0;
+
+    // The calling thread keeps the first chunk and hands out the rest
+    for (unsigned int begin = chunkSize; begin < count; begin += chunkSize)
+    {
+        const unsigned int end = min(begin + chunkSize, count);
+
+        {
+            lock_guard<mutex> g(mutexPending);
+            pending++;
+        }
+
+        m_verifyPool->AddJob([&verifyRange, &mutexPending, &cvPending,
+                              &pending, begin, end]() {
+            verifyRange(begin, end);
+
+            lock_guard<mutex> g(mutexPending);
+            if (--pending == 0)
+            {
+                cvPending.notify_one();
+            }
+        });
+    }
+
+    verifyRange(0, min(chunkSize, count));
+
+    {
+        unique_lock<mutex> g(mutexPending);
+        cvPending.wait(g, [&pending] { return pending == 0; });
+    }
+
+    results.assign(valid.begin(), valid.end());
+
+    return all_of(valid.begin(), valid.end(),
+                  [](unsigned char v) { return v != 0; });
+}
+
 void Schnorr::PrintPoint(const EC_POINT* point)
 {
     LOG_MARKER();
-    lock_guard<mutex> g(m_mutexSchnorr);
 
     unique_ptr<BIGNUM, void (*)(BIGNUM*)> x(BN_new(), BN_clear_free);
     unique_ptr<BIGNUM, void (*)(BIGNUM*)> y(BN_new(), BN_clear_free);
@@ -1054,7 +1159,8 @@ void Schnorr::PrintPoint(const EC_POINT* point)
     {
         // Get affine coordinates for the point
         if (EC_POINT_get_affine_coordinates_GFp(m_curve.m_group.get(), point,
-                                                x.get(), y.get(), NULL))
+                                                x.get(), y.get(),
+                                                GetBNCtx()))
         {
             unique_ptr<char, void (*)(void*)> x_str(BN_bn2hex(x.get()), free);
             unique_ptr<char, void (*)(void*)> y_str(BN_bn2hex(y.get()), free);
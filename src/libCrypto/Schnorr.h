@@ -48,8 +48,6 @@ struct Curve
 /// EC-Schnorr utility for serializing BIGNUM data type.
 struct BIGNUMSerialize
 {
-    static std::mutex m_mutexBIGNUM;
-
     /// Deserializes a BIGNUM from specified byte stream.
     static std::shared_ptr<BIGNUM>
     GetNumber(const std::vector<unsigned char>& src, unsigned int offset,
@@ -63,8 +61,6 @@ struct BIGNUMSerialize
 /// EC-Schnorr utility for serializing ECPOINT data type.
 struct ECPOINTSerialize
 {
-    static std::mutex m_mutexECPOINT;
-
     /// Deserializes an ECPOINT from specified byte stream.
     static std::shared_ptr<EC_POINT>
     GetNumber(const std::vector<unsigned char>& src, unsigned int offset,
@@ -134,6 +130,11 @@ struct PubKey : public Serializable
     /// Flag to indicate if parameters have been initialized.
     bool m_initialized;
 
+    /// Compressed encoding of m_P kept from deserialization, valid while m_hasCompressed is set.
+    /// Code that writes into m_P directly must clear m_hasCompressed.
+    std::array<unsigned char, PUB_KEY_SIZE> m_compressed;
+    bool m_hasCompressed;
+
     /// Default constructor for an uninitialized key.
     PubKey();
 
@@ -237,11 +238,60 @@ inline std::ostream& operator<<(std::ostream& os, const Signature& s)
     return os;
 }
 
+/// Refers to one (message, signature, public key) entry of a verification batch.
+struct SignedMessageRef
+{
+    /// Byte stream holding the signed message.
+    const std::vector<unsigned char>& m_message;
+
+    /// Offset of the signed message within the byte stream.
+    unsigned int m_offset;
+
+    /// Size of the signed message.
+    unsigned int m_size;
+
+    /// Signature to check.
+    const Signature& m_signature;
+
+    /// Public key of the signer.
+    const PubKey& m_pubkey;
+
+    /// Constructor for a signature over the whole byte stream.
+    SignedMessageRef(const std::vector<unsigned char>& message,
+                     const Signature& signature, const PubKey& pubkey)
+        : m_message(message)
+        , m_offset(0)
+        , m_size(message.size())
+        , m_signature(signature)
+        , m_pubkey(pubkey)
+    {
+    }
+
+    /// Constructor for a signature over part of the byte stream.
+    SignedMessageRef(const std::vector<unsigned char>& message,
+                     unsigned int offset, unsigned int size,
+                     const Signature& signature, const PubKey& pubkey)
+        : m_message(message)
+        , m_offset(offset)
+        , m_size(size)
+        , m_signature(signature)
+        , m_pubkey(pubkey)
+    {
+    }
+};
+
+class ThreadPool;
+
 /// Implements the Elliptic Curve Based Schnorr Signature algorithm.
+/// The curve is never modified after construction and every thread uses its own BN_CTX,
+/// so all operations may run concurrently without locking.
 class Schnorr
 {
     Curve m_curve;
 
+    /// Workers that share the entries of large verification batches.
+    std::unique_ptr<ThreadPool> m_verifyPool;
+
     Schnorr();
     ~Schnorr();
 
@@ -255,14 +305,15 @@ public:
     /// Hence a total of 33 bytes.
     static const unsigned int PUBKEY_COMPRESSED_SIZE_BYTES = 33;
 
-    std::mutex m_mutexSchnorr;
-
     /// Returns the singleton Schnorr instance.
     static Schnorr& GetInstance();
 
     /// Returns the EC curve used.
     const Curve& GetCurve() const;
 
+    /// Returns the calling thread's BN_CTX scratch space.
+    static BN_CTX* GetBNCtx();
+
     /// Generates a new PrivKey and PubKey pair.
     std::pair<PrivKey, PubKey> GenKeyPair();
 
@@ -284,6 +335,11 @@ public:
                 unsigned int size, const Signature& toverify,
                 const PubKey& pubkey);
 
+    /// Checks every signature of a batch, spreading the entries over all cores.
+    /// results[i] tells whether batch[i] is valid; returns true only if all of them are.
+    bool BatchVerify(const std::vector<SignedMessageRef>& batch,
+                     std::vector<bool>& results);
+
     /// Utility function for printing EC_POINT coordinates.
     void PrintPoint(const EC_POINT* point);
 };
@@ -18,6 +18,7 @@
 #define __SHA2_H__
 
 #include "libUtils/Logger.h"
+#include <array>
 #include <openssl/sha.h>
 #include <vector>
 
@@ -29,6 +30,32 @@ public:
     static const unsigned int HASH_VARIANT_512 = 512;
 };
 
+/// Read-only view of bytes to be hashed, so callers don't have to copy them into a vector.
+struct ByteSpan
+{
+    const unsigned char* m_data;
+    size_t m_size;
+
+    ByteSpan(const unsigned char* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    ByteSpan(const std::vector<unsigned char>& input)
+        : m_data(input.data())
+        , m_size(input.size())
+    {
+    }
+
+    template<size_t N>
+    ByteSpan(const std::array<unsigned char, N>& input)
+        : m_data(input.data())
+        , m_size(N)
+    {
+    }
+};
+
 /// Implements SHA2 hash algorithm.
 template<unsigned int SIZE> class SHA2
 {
@@ -37,6 +64,9 @@ template<unsigned int SIZE> class SHA2
     std::vector<unsigned char> output;
 
 public:
+    /// Fixed-size digest, e.g. the array underneath a dev::h256.
+    typedef std::array<unsigned char, HASH_OUTPUT_SIZE> Digest;
+
     /// Constructor.
     SHA2()
         : output(HASH_OUTPUT_SIZE)
@@ -57,16 +87,15 @@ public:
     /// Hash update function.
     void Update(const std::vector<unsigned char>& input)
     {
-        if (input.size() <= 0)
-        {
-            LOG_GENERAL(FATAL,
-                        "assertion failed (" << __FILE__ << ":" << __LINE__
-                                             << ": " << __FUNCTION__ << ")");
-        }
-
         SHA256_Update(&m_context, input.data(), input.size());
     }
 
+    /// Hash update function (no copy; empty input is allowed).
+    void Update(const ByteSpan& input)
+    {
+        SHA256_Update(&m_context, input.m_data, input.m_size);
+    }
+
     /// Hash update function.
     void Update(const std::vector<unsigned char>& input, unsigned int offset,
                 unsigned int size)
@@ -97,6 +126,12 @@ public:
         }
         return output;
     }
+
+    /// Hash finalize function, writing straight into the caller's digest.
+    void Finalize(Digest& digest)
+    {
+        SHA256_Final(digest.data(), &m_context);
+    }
 };
 
 #endif // __SHA2_H__
\ No newline at end of file
@@ -0,0 +1,348 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "Sha2Batch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define SHA2BATCH_X86
+#endif
+
+using namespace std;
+
+namespace
+{
+    const unsigned int LANES = 8;
+    const unsigned int BLOCK_SIZE = 64;
+
+    // The kernel only pays off once a few lanes are filled
+    const unsigned int MIN_MULTI_BUFFER_INPUTS = 4;
+
+    const uint32_t K[64]
+        = {0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b,
+           0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01,
+           0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7,
+           0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+           0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152,
+           0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+           0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+           0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+           0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819,
+           0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08,
+           0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f,
+           0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+           0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+    const uint32_t H0[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    /// Number of 64-byte blocks in the padded message.
+    size_t PaddedBlocks(size_t size)
+    {
+        return (size + 9 + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    }
+
+    /// Writes block number `block` of the padded message into `out`.
+    void PaddedBlock(const ByteSpan& input, size_t block, unsigned char* out)
+    {
+        const size_t start = block * BLOCK_SIZE;
+        size_t copied = 0;
+
+        if (start < input.m_size)
+        {
+            copied = min<size_t>(BLOCK_SIZE, input.m_size - start);
+            memcpy(out, input.m_data + start, copied);
+        }
+        memset(out + copied, 0, BLOCK_SIZE - copied);
+
+        if ((start <= input.m_size) && (input.m_size < start + BLOCK_SIZE))
+        {
+            out[input.m_size - start] = 0x80;
+        }
+
+        if (block == PaddedBlocks(input.m_size) - 1)
+        {
+            const uint64_t bits = static_cast<uint64_t>(input.m_size) * 8;
+            for (unsigned int i = 0; i < 8; i++)
+            {
+                out[BLOCK_SIZE - 1 - i]
+                    = static_cast<unsigned char>(bits >> (8 * i));
+            }
+        }
+    }
+
+    void HashEach(const vector<ByteSpan>& inputs,
+                  vector<SHA256Batch::Digest>& digests)
+    {
+        for (unsigned int i = 0; i < inputs.size(); i++)
+        {
+            SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+            sha2.Update(inputs[i]);
+            sha2.Finalize(digests[i]);
+        }
+    }
+
+#ifdef SHA2BATCH_X86
+    /// The CPUID bit alone is not enough: the OS must also save the YMM registers
+    /// on context switches (OSXSAVE set and XCR0 enabling both XMM and YMM state).
+    bool CpuHasAVX2()
+    {
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0
+            || (ecx & bit_OSXSAVE) == 0 || (ecx & bit_AVX) == 0)
+        {
+            return false;
+        }
+
+        unsigned int xcr0Low, xcr0High;
+        __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+        if ((xcr0Low & 6) != 6)
+        {
+            return false;
+        }
+
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0)
+        {
+            return false;
+        }
+        return (ebx & bit_AVX2) != 0;
+    }
+
+    bool CpuHasSHA()
+    {
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0)
+        {
+            return false;
+        }
+        return (ebx & (1u << 29)) != 0;
+    }
+
+#define ROTR(x, n)                                                             \
+    _mm256_or_si256(_mm256_srli_epi32((x), (n)),                              \
+                    _mm256_slli_epi32((x), 32 - (n)))
+
+    /// Runs one compression on eight lanes.
+    /// Lanes whose mask in `active` is clear keep their state.
+    __attribute__((target("avx2"))) void
+    CompressLanes(__m256i state[8], const uint32_t words[16][LANES],
+                  const uint32_t active[LANES])
+    {
+        __m256i w[16];
+        for (unsigned int t = 0; t < 16; t++)
+        {
+            w[t] = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(words[t]));
+        }
+
+        __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+        __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (unsigned int t = 0; t < 64; t++)
+        {
+            __m256i wt;
+            if (t < 16)
+            {
+                wt = w[t];
+            }
+            else
+            {
+                const __m256i w15 = w[(t - 15) & 15];
+                const __m256i w2 = w[(t - 2) & 15];
+                const __m256i s0 = _mm256_xor_si256(
+                    _mm256_xor_si256(ROTR(w15, 7), ROTR(w15, 18)),
+                    _mm256_srli_epi32(w15, 3));
+                const __m256i s1 = _mm256_xor_si256(
+                    _mm256_xor_si256(ROTR(w2, 17), ROTR(w2, 19)),
+                    _mm256_srli_epi32(w2, 10));
+                wt = _mm256_add_epi32(
+                    _mm256_add_epi32(w[t & 15], s0),
+                    _mm256_add_epi32(w[(t - 7) & 15], s1));
+                w[t & 15] = wt;
+            }
+
+            const __m256i S1 = _mm256_xor_si256(
+                _mm256_xor_si256(ROTR(e, 6), ROTR(e, 11)), ROTR(e, 25));
+            const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f),
+                                                _mm256_andnot_si256(e, g));
+            const __m256i t1 = _mm256_add_epi32(
+                _mm256_add_epi32(_mm256_add_epi32(h, S1),
+                                 _mm256_add_epi32(ch, wt)),
+                _mm256_set1_epi32(static_cast<int>(K[t])));
+            const __m256i S0 = _mm256_xor_si256(
+                _mm256_xor_si256(ROTR(a, 2), ROTR(a, 13)), ROTR(a, 22));
+            const __m256i maj = _mm256_or_si256(
+                _mm256_and_si256(a, b),
+                _mm256_and_si256(c, _mm256_or_si256(a, b)));
+            const __m256i t2 = _mm256_add_epi32(S0, maj);
+
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi32(d, t1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi32(t1, t2);
+        }
+
+        const __m256i mask
+            = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(active));
+        const __m256i next[8] = {a, b, c, d, e, f, g, h};
+        for (unsigned int i = 0; i < 8; i++)
+        {
+            state[i] = _mm256_blendv_epi8(
+                state[i], _mm256_add_epi32(state[i], next[i]), mask);
+        }
+    }
+
+#undef ROTR
+
+    /// Hashes up to eight inputs, given by index, side by side.
+    __attribute__((target("avx2"))) void
+    HashLanes(const vector<ByteSpan>& inputs, const size_t* indices,
+              unsigned int count, vector<SHA256Batch::Digest>& digests)
+    {
+        __m256i state[8];
+        for (unsigned int i = 0; i < 8; i++)
+        {
+            state[i] = _mm256_set1_epi32(static_cast<int>(H0[i]));
+        }
+
+        size_t blocks[LANES] = {0};
+        size_t maxBlocks = 0;
+        for (unsigned int lane = 0; lane < count; lane++)
+        {
+            blocks[lane] = PaddedBlocks(inputs[indices[lane]].m_size);
+            maxBlocks = max(maxBlocks, blocks[lane]);
+        }
+
+        unsigned char block[BLOCK_SIZE];
+        alignas(32) uint32_t words[16][LANES];
+        alignas(32) uint32_t active[LANES];
+
+        for (size_t n = 0; n < maxBlocks; n++)
+        {
+            for (unsigned int lane = 0; lane < LANES; lane++)
+            {
+                active[lane] = (n < blocks[lane]) ? 0xffffffff : 0;
+
+                if (active[lane] == 0)
+                {
+                    memset(block, 0, BLOCK_SIZE);
+                }
+                else
+                {
+                    PaddedBlock(inputs[indices[lane]], n, block);
+                }
+
+                for (unsigned int t = 0; t < 16; t++)
+                {
+                    words[t][lane] = (uint32_t(block[4 * t]) << 24)
+                        | (uint32_t(block[4 * t + 1]) << 16)
+                        | (uint32_t(block[4 * t + 2]) << 8)
+                        | uint32_t(block[4 * t + 3]);
+                }
+            }
+
+            CompressLanes(state, words, active);
+        }
+
+        alignas(32) uint32_t out[8][LANES];
+        for (unsigned int i = 0; i < 8; i++)
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(out[i]), state[i]);
+        }
+
+        for (unsigned int lane = 0; lane < count; lane++)
+        {
+            SHA256Batch::Digest& digest = digests[indices[lane]];
+            for (unsigned int i = 0; i < 8; i++)
+            {
+                const uint32_t word = out[i][lane];
+                digest[4 * i] = static_cast<unsigned char>(word >> 24);
+                digest[4 * i + 1] = static_cast<unsigned char>(word >> 16);
+                digest[4 * i + 2] = static_cast<unsigned char>(word >> 8);
+                digest[4 * i + 3] = static_cast<unsigned char>(word);
+            }
+        }
+    }
+#endif // SHA2BATCH_X86
+}
+
+bool SHA256Batch::UsesMultiBuffer()
+{
+#ifdef SHA2BATCH_X86
+    static const bool useMultiBuffer = CpuHasAVX2() && !CpuHasSHA();
+    return useMultiBuffer;
+#else
+    return false;
+#endif
+}
+
+bool SHA256Batch::HashMultiBuffer(const vector<ByteSpan>& inputs,
+                                  vector<Digest>& digests)
+{
+#ifdef SHA2BATCH_X86
+    static const bool hasAVX2 = CpuHasAVX2();
+    if (!hasAVX2)
+    {
+        return false;
+    }
+
+    digests.resize(inputs.size());
+
+    // Lanes run until their longest input is done,
+    // so group inputs of similar length
+    vector<size_t> order(inputs.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(), [&inputs](size_t x, size_t y) {
+        return PaddedBlocks(inputs[x].m_size) < PaddedBlocks(inputs[y].m_size);
+    });
+
+    for (size_t i = 0; i < order.size(); i += LANES)
+    {
+        const size_t count = min<size_t>(LANES, order.size() - i);
+        HashLanes(inputs, order.data() + i, static_cast<unsigned int>(count),
+                  digests);
+    }
+
+    return true;
+#else
+    (void)inputs;
+    (void)digests;
+    return false;
+#endif
+}
+
+void SHA256Batch::Hash(const vector<ByteSpan>& inputs, vector<Digest>& digests)
+{
+    if (UsesMultiBuffer() && (inputs.size() >= MIN_MULTI_BUFFER_INPUTS)
+        && HashMultiBuffer(inputs, digests))
+    {
+        return;
+    }
+
+    digests.resize(inputs.size());
+    HashEach(inputs, digests);
+}
@@ -0,0 +1,44 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+#ifndef __SHA2BATCH_H__
+#define __SHA2BATCH_H__
+
+#include <vector>
+
+#include "Sha2.h"
+
+/// Computes the SHA-256 of many independent inputs in one call.
+/// On CPUs with AVX2 but without the SHA extensions, eight inputs are hashed side by side in one kernel.
+/// Otherwise each input goes through OpenSSL, whose single-buffer code already uses the SHA extensions.
+class SHA256Batch
+{
+public:
+    typedef SHA2<HASH_TYPE::HASH_VARIANT_256>::Digest Digest;
+
+    /// Hashes inputs[i] into digests[i]; digests is resized to match.
+    static void Hash(const std::vector<ByteSpan>& inputs,
+                     std::vector<Digest>& digests);
+
+    /// Hashes with the eight-lane kernel regardless of the CPU's SHA extensions.
+    /// Returns false (and leaves digests alone) if the CPU has no AVX2.
+    static bool HashMultiBuffer(const std::vector<ByteSpan>& inputs,
+                                std::vector<Digest>& digests);
+
+    /// Returns true if Hash uses the eight-lane kernel on this CPU.
+    static bool UsesMultiBuffer();
+};
+
+#endif // __SHA2BATCH_H__
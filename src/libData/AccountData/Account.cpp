@@ -19,6 +19,7 @@
 #include "depends/common/CommonIO.h"
 #include "depends/common/FixedHash.h"
 #include "depends/common/RLP.h"
+#include "libCrypto/PubKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libPersistence/ContractStorage.h"
 #include "libUtils/DataConversion.h"
@@ -41,6 +42,7 @@ Account::Account(const uint256_t& balance, const uint256_t& nonce)
     , m_nonce(nonce)
     , m_storageRoot(h256())
     , m_codeHash(h256())
+    , m_dirty(DIRTY_BALANCE_NONCE)
 {
 }
 
@@ -220,6 +222,7 @@ int Account::DeserializeAddOffset(const vector<unsigned char>& src,
         m_nonce = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
         // LOG_GENERAL(INFO, "nonce: " << m_nonce);
         offset += UINT256_SIZE;
+        m_dirty |= DIRTY_BALANCE_NONCE;
         // Storage Root
         h256 t_storageRoot;
         copy(src.begin() + offset, src.begin() + offset + COMMON_HASH_SIZE,
@@ -465,9 +468,9 @@ int Account::DeserializeDelta(const vector<unsigned char>& src,
         uint256_t balanceDeltaNum
             = GetNumber<uint256_t>(src, offset, UINT256_SIZE);
         offset += UINT256_SIZE;
-        int balanceDelta = (numsign == NumberSign::POSITIVE)
-            ? (int)balanceDeltaNum
-            : 0 - (int)balanceDeltaNum;
+        int256_t balanceDelta = (numsign == NumberSign::POSITIVE)
+            ? int256_t(balanceDeltaNum)
+            : 0 - int256_t(balanceDeltaNum);
         // LOG_GENERAL(INFO, "balanceDelta: " << balanceDelta);
         account.ChangeBalance(balanceDelta);
         // Nonce Delta
@@ -601,6 +604,7 @@ int Account::DeserializeDelta(const vector<unsigned char>& src,
 
 bool Account::IncreaseBalance(const uint256_t& delta)
 {
+    m_dirty |= DIRTY_BALANCE_NONCE;
     return SafeMath<uint256_t>::add(m_balance, delta, m_balance);
 }
 
@@ -611,6 +615,7 @@ bool Account::DecreaseBalance(const uint256_t& delta)
         return false;
     }
 
+    m_dirty |= DIRTY_BALANCE_NONCE;
     return SafeMath<uint256_t>::sub(m_balance, delta, m_balance);
 }
 
@@ -623,12 +628,14 @@ bool Account::ChangeBalance(const int256_t& delta)
 bool Account::IncreaseNonce()
 {
     ++m_nonce;
+    m_dirty |= DIRTY_BALANCE_NONCE;
     return true;
 }
 
 bool Account::IncreaseNonceBy(const uint256_t& nonceDelta)
 {
     m_nonce += nonceDelta;
+    m_dirty |= DIRTY_BALANCE_NONCE;
     return true;
 }
 
@@ -639,6 +646,7 @@ void Account::SetStorageRoot(const h256& root)
         return;
     }
     m_storageRoot = root;
+    m_dirty |= DIRTY_STORAGE;
 
     if (m_storageRoot == h256())
     {
@@ -661,6 +669,7 @@ void Account::SetStorage(string k, string type, string v, bool is_mutable)
     m_storage.insert(GetKeyHash(k), rlpStream.out());
 
     m_storageRoot = m_storage.root();
+    m_dirty |= DIRTY_STORAGE;
 }
 
 void Account::SetStorage(const h256& k_hash, const string& rlpStr)
@@ -673,6 +682,7 @@ void Account::SetStorage(const h256& k_hash, const string& rlpStr)
     }
     m_storage.insert(k_hash, rlpStr);
     m_storageRoot = m_storage.root();
+    m_dirty |= DIRTY_STORAGE;
 }
 
 vector<string> Account::GetStorage(const string& _k) const
@@ -781,6 +791,7 @@ void Account::RollBack()
         return;
     }
     m_storageRoot = m_prevRoot;
+    m_dirty &= ~DIRTY_STORAGE;
     if (m_storageRoot != h256())
     {
         m_storage.setRoot(m_storageRoot);
@@ -793,25 +804,16 @@ void Account::RollBack()
 
 Address Account::GetAddressFromPublicKey(const PubKey& pubKey)
 {
-    Address address;
-
-    vector<unsigned char> vec;
-    pubKey.Serialize(vec, 0);
-    SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
-    sha2.Update(vec);
-
-    const vector<unsigned char>& output = sha2.Finalize();
-
-    if (output.size() != 32)
+    // Received keys still carry their wire bytes, so only local ones need encoding
+    if (pubKey.m_hasCompressed)
     {
-        LOG_GENERAL(WARNING,
-                    "assertion failed (" << __FILE__ << ":" << __LINE__ << ": "
-                                         << __FUNCTION__ << ")");
+        return PubKeyCache::GetInstance().GetAddress(pubKey.m_compressed);
     }
 
-    copy(output.end() - ACC_ADDR_SIZE, output.end(), address.asArray().begin());
+    vector<unsigned char> vec;
+    pubKey.Serialize(vec, 0);
 
-    return address;
+    return PubKeyCache::GetInstance().GetAddress(vec, 0);
 }
 
 Address Account::GetAddressForContract(const Address& sender,
@@ -854,6 +856,7 @@ void Account::SetCode(const vector<unsigned char>& code)
     sha2.Update(code);
     m_codeHash = dev::h256(sha2.Finalize());
     // LOG_GENERAL(INFO, "m_codeHash: " << m_codeHash);
+    m_dirty |= DIRTY_CODE;
 
     InitStorage();
 }
@@ -47,6 +47,17 @@ using AccountTrieDB = SpecificTrieDB<dev::GenericTrieDB<DB>, KeyType>;
 
 class Account : public Serializable
 {
+public:
+    /// Parts of the account changed since it was last flushed to disk.
+    enum DirtyFlag : unsigned char
+    {
+        DIRTY_NONE = 0x00,
+        DIRTY_BALANCE_NONCE = 0x01,
+        DIRTY_STORAGE = 0x02,
+        DIRTY_CODE = 0x04,
+    };
+
+private:
     uint256_t m_balance;
     uint256_t m_nonce;
     h256 m_storageRoot, m_prevRoot;
@@ -56,6 +67,7 @@ class Account : public Serializable
     Json::Value m_initValJson;
     vector<unsigned char> m_initData;
     vector<unsigned char> m_codeCache;
+    unsigned char m_dirty = DIRTY_NONE;
 
     const h256 GetKeyHash(const string& key) const;
 
@@ -111,7 +123,11 @@ public:
 
     bool ChangeBalance(const int256_t& delta);
 
-    void SetBalance(const uint256_t& balance) { m_balance = balance; }
+    void SetBalance(const uint256_t& balance)
+    {
+        m_balance = balance;
+        m_dirty |= DIRTY_BALANCE_NONCE;
+    }
 
     /// Returns the account balance.
     const uint256_t& GetBalance() const { return m_balance; }
@@ -161,7 +177,21 @@ public:
 
     Json::Value GetStorageJson() const;
 
-    void Commit() { m_prevRoot = m_storageRoot; }
+    /// Returns true if any of the given parts changed since the last flush.
+    bool IsDirty(unsigned char flags = DIRTY_BALANCE_NONCE | DIRTY_STORAGE
+                     | DIRTY_CODE) const
+    {
+        return (m_dirty & flags) != 0;
+    }
+
+    /// Marks the account as matching what is on disk.
+    void ClearDirty() { m_dirty = DIRTY_NONE; }
+
+    void Commit()
+    {
+        m_prevRoot = m_storageRoot;
+        m_dirty = DIRTY_NONE;
+    }
 
     void RollBack();
 
@@ -14,6 +14,7 @@
 * and which include a reference to GPLv3 in their program files.
 **/
 
+#include <algorithm>
 #include <leveldb/db.h>
 
 #include "AccountStore.h"
@@ -24,6 +25,7 @@
 #include "libUtils/SysCommand.h"
 
 AccountStore::AccountStore()
+    : m_deltaSerialized(false)
 {
     m_accountStoreTemp = make_unique<AccountStoreTemp>(*this);
 }
@@ -46,7 +48,7 @@ void AccountStore::InitSoft()
 {
     LOG_MARKER();
 
-    AccountStoreTrie<OverlayDB, unordered_map<Address, Account>>::Init();
+    AccountStoreTrie<OverlayDB, AddressMap<Account>>::Init();
 
     InitTemp();
 }
@@ -112,6 +114,7 @@ void AccountStore::SerializeDelta()
 
     lock_guard<mutex> g(m_mutexDelta);
 
+    m_deltaSerialized = true;
     m_stateDeltaSerialized.clear();
     // [Total number of acount deltas (uint256_t)] [Addr 1] [AccountDelta 1] [Addr 2] [Account 2] .... [Addr n] [Account n]
     unsigned int curOffset = 0;
@@ -124,23 +127,36 @@ void AccountStore::SerializeDelta()
                          UINT256_SIZE);
     curOffset += UINT256_SIZE;
 
+    // The temp store is unordered, but every node must produce the same delta
+    vector<const pair<const Address, Account>*> entries;
+    entries.reserve(m_accountStoreTemp->GetAddressToAccount()->size());
+    for (const auto& entry : *m_accountStoreTemp->GetAddressToAccount())
+    {
+        entries.emplace_back(&entry);
+    }
+    sort(entries.begin(), entries.end(),
+         [](const pair<const Address, Account>* lhs,
+            const pair<const Address, Account>* rhs) {
+             return lhs->first < rhs->first;
+         });
+
     vector<unsigned char> address_vec;
     // [Addr 1] [Account 1] [Addr 2] [Account 2] .... [Addr n] [Account n]
-    for (const auto& entry : *m_accountStoreTemp->GetAddressToAccount())
+    for (const auto& entry : entries)
     {
-        // LOG_GENERAL(INFO, "Addr: " << entry.first);
+        // LOG_GENERAL(INFO, "Addr: " << entry->first);
 
         // Address
-        address_vec = entry.first.asBytes();
+        address_vec = entry->first.asBytes();
 
         copy(address_vec.begin(), address_vec.end(),
              std::back_inserter(m_stateDeltaSerialized));
         curOffset += ACC_ADDR_SIZE;
 
         // Account
-        Account* account = GetAccount(entry.first);
+        Account* account = GetAccount(entry->first);
         unsigned int size_needed = Account::SerializeDelta(
-            m_stateDeltaSerialized, curOffset, account, entry.second);
+            m_stateDeltaSerialized, curOffset, account, entry->second);
         curOffset += size_needed;
     }
 }
@@ -224,6 +240,15 @@ int AccountStore::DeserializeDeltaTemp(const vector<unsigned char>& src,
                                        unsigned int offset)
 {
     lock_guard<mutex> g(m_mutexDelta);
+
+    if (m_deltaSerialized)
+    {
+        LOG_GENERAL(WARNING,
+                    "State delta already serialized for this block, "
+                    "rejecting a late delta");
+        return -1;
+    }
+
     return m_accountStoreTemp->DeserializeDelta(src, offset);
 }
 
@@ -239,10 +264,17 @@ void AccountStore::MoveUpdatesToDisk()
     LOG_MARKER();
 
     ContractStorage::GetContractStorage().GetStateDB().commit();
-    for (auto i : *m_addressToAccount)
+    for (auto& i : *m_addressToAccount)
     {
-        if (!ContractStorage::GetContractStorage().PutContractCode(
-                i.first, i.second.GetCode()))
+        if (!i.second.IsDirty())
+        {
+            continue;
+        }
+
+        // Code never changes once set, so it only goes to disk the first time
+        if (i.second.IsDirty(Account::DIRTY_CODE)
+            && !ContractStorage::GetContractStorage().PutContractCode(
+                   i.first, i.second.GetCode()))
         {
             LOG_GENERAL(WARNING, "Write Contract Code to Disk Failed");
             continue;
@@ -259,10 +291,6 @@ void AccountStore::DiscardUnsavedUpdates()
     LOG_MARKER();
 
     ContractStorage::GetContractStorage().GetStateDB().rollback();
-    for (auto i : *m_addressToAccount)
-    {
-        i.second.RollBack();
-    }
     m_state.db()->rollback();
     m_state.setRoot(prevRoot);
     m_addressToAccount->clear();
@@ -304,6 +332,7 @@ bool AccountStore::RetrieveFromDisk()
             // Storage Root
             account.SetStorageRoot(rlp[2].toHash<h256>());
         }
+        account.ClearDirty();
         m_addressToAccount->insert({address, account});
     }
     return true;
@@ -319,6 +348,15 @@ bool AccountStore::UpdateAccountsTemp(const uint64_t& blockNum,
     return m_accountStoreTemp->UpdateAccounts(blockNum, transaction);
 }
 
+void AccountStore::UpdateAccountsTempBatch(const uint64_t& blockNum,
+                                           const vector<Transaction>& txns,
+                                           vector<bool>& results)
+{
+    lock_guard<mutex> g(m_mutexDelta);
+
+    m_accountStoreTemp->UpdateAccountsBatch(blockNum, txns, results);
+}
+
 bool AccountStore::UpdateCoinbaseTemp(const Address& rewardee,
                                       const Address& genesisAddress,
                                       const uint256_t& amount)
@@ -365,12 +403,19 @@ void AccountStore::CommitTemp()
 {
     LOG_MARKER();
 
-    // LOG_GENERAL(INFO, "Before CommitTemp");
+    {
+        lock_guard<mutex> g(m_mutexDelta);
 
-    // LOG_PAYLOAD(INFO, "m_stateDeltaSerialized: ", m_stateDeltaSerialized, 2000);
-    DeserializeDelta(m_stateDeltaSerialized, 0);
+        // The temp store already holds the updated accounts, so merge them
+        // as-is instead of re-parsing m_stateDeltaSerialized, which is only
+        // kept for broadcasting and hashing
+        for (const auto& entry : *m_accountStoreTemp->GetAddressToAccount())
+        {
+            (*m_addressToAccount)[entry.first] = entry.second;
+            UpdateStateTrie(entry.first, entry.second);
+        }
+    }
 
-    // LOG_GENERAL(INFO, "After CommitTemp");
     InitTemp();
 }
 
@@ -381,4 +426,5 @@ void AccountStore::InitTemp()
     lock_guard<mutex> g(m_mutexDelta);
 
     m_accountStoreTemp->Init();
+    m_deltaSerialized = false;
 }
\ No newline at end of file
@@ -28,6 +28,7 @@
 #include "AccountStoreSC.h"
 #include "AccountStoreTrie.h"
 #include "Address.h"
+#include "AddressMap.h"
 #include "common/Constants.h"
 #include "common/Singleton.h"
 #include "depends/common/FixedHash.h"
@@ -40,27 +41,47 @@
 using StateHash = dev::h256;
 
 class AccountStore;
+class ThreadPool;
 
-class AccountStoreTemp : public AccountStoreSC<map<Address, Account>>
+class AccountStoreTemp : public AccountStoreSC<AddressMap<Account>>
 {
     // shared_ptr<unordered_map<Address, Account>> m_superAddressToAccount;
     AccountStore& m_parent;
 
+    std::unique_ptr<ThreadPool> m_transferPool;
+
+    /// Runs work on the calling thread and on up to maxHelpers pool threads, returning when all are done.
+    void RunConcurrently(const std::function<void()>& work,
+                         unsigned int maxHelpers);
+
+    /// Applies a run of normal transactions, running those that share no account concurrently.
+    void ApplyTransfers(const uint64_t& blockNum,
+                        const vector<Transaction>& txns,
+                        const vector<unsigned int>& indexes,
+                        vector<bool>& results);
+
 public:
     // AccountStoreTemp(
     //     const shared_ptr<unordered_map<Address, Account>>& addressToAccount);
     AccountStoreTemp(AccountStore& parent);
+    ~AccountStoreTemp();
+
+    /// Applies the transactions in order, skipping those whose result is already false.
+    /// Leaves the store exactly as calling UpdateAccounts on each one in turn would.
+    void UpdateAccountsBatch(const uint64_t& blockNum,
+                             const vector<Transaction>& txns,
+                             vector<bool>& results);
 
     int DeserializeDelta(const vector<unsigned char>& src, unsigned int offset);
 
     /// Returns the Account associated with the specified address.
     Account* GetAccount(const Address& address) override;
 
-    const shared_ptr<map<Address, Account>>& GetAddressToAccount();
+    const shared_ptr<AddressMap<Account>>& GetAddressToAccount();
 };
 
 class AccountStore
-    : public AccountStoreTrie<OverlayDB, unordered_map<Address, Account>>,
+    : public AccountStoreTrie<OverlayDB, AddressMap<Account>>,
       Singleton<AccountStore>
 {
     unique_ptr<AccountStoreTemp> m_accountStoreTemp;
@@ -69,6 +90,10 @@ class AccountStore
 
     vector<unsigned char> m_stateDeltaSerialized;
 
+    /// Set once the delta is serialized for a block. CommitTemp merges the temp store
+    /// as-is, so no further deltas may be folded into it until InitTemp.
+    bool m_deltaSerialized;
+
     AccountStore();
     ~AccountStore();
 
@@ -88,6 +113,7 @@ public:
 
     int DeserializeDelta(const vector<unsigned char>& src, unsigned int offset);
 
+    /// Folds a received delta into the temp store. Fails once SerializeDelta has run, until InitTemp.
     int DeserializeDeltaTemp(const vector<unsigned char>& src,
                              unsigned int offset);
 
@@ -104,6 +130,10 @@ public:
     bool UpdateAccountsTemp(const uint64_t& blockNum,
                             const Transaction& transaction);
 
+    void UpdateAccountsTempBatch(const uint64_t& blockNum,
+                                 const vector<Transaction>& txns,
+                                 vector<bool>& results);
+
     void AddAccountTemp(const Address& address, const Account& account)
     {
         m_accountStoreTemp->AddAccount(address, account);
@@ -115,6 +145,7 @@ public:
 
     StateHash GetStateDeltaHash();
 
+    /// Merges the temp store into the main store, which matches the last SerializeDelta.
     void CommitTemp();
 
     void InitTemp();
@@ -24,8 +24,7 @@ template<class MAP>
 Account* AccountStoreAtomic<MAP>::GetAccount(const Address& address)
 {
     Account* account
-        = AccountStoreBase<std::unordered_map<Address, Account>>::GetAccount(
-            address);
+        = AccountStoreBase<AddressMap<Account>>::GetAccount(address);
     if (account != nullptr)
     {
         // LOG_GENERAL(INFO, "Got From Temp");
@@ -36,8 +35,8 @@ Account* AccountStoreAtomic<MAP>::GetAccount(const Address& address)
     if (account)
     {
         // LOG_GENERAL(INFO, "Got From Parent");
-        m_addressToAccount->insert(make_pair(address, *account));
-        return &(m_addressToAccount->find(address))->second;
+        return &m_addressToAccount->insert(make_pair(address, *account))
+                    .first->second;
     }
 
     // LOG_GENERAL(INFO, "Got Nullptr");
@@ -46,7 +45,7 @@ Account* AccountStoreAtomic<MAP>::GetAccount(const Address& address)
 }
 
 template<class MAP>
-const std::shared_ptr<std::unordered_map<Address, Account>>&
+const std::shared_ptr<AddressMap<Account>>&
 AccountStoreAtomic<MAP>::GetAddressToAccount()
 {
     return this->m_addressToAccount;
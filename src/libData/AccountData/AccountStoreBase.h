@@ -53,6 +53,10 @@ public:
 
     bool UpdateAccounts(const Transaction& transaction);
 
+    /// Same as above, for a sender address the caller already derived.
+    bool UpdateAccounts(const Transaction& transaction,
+                        const Address& fromAddr);
+
     /// Verifies existence of Account in the list.
     bool IsAccountExist(const Address& address);
 
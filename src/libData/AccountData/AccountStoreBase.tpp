@@ -127,7 +127,14 @@ template<class MAP>
 bool AccountStoreBase<MAP>::UpdateAccounts(const Transaction& transaction)
 {
     const PubKey& senderPubKey = transaction.GetSenderPubKey();
-    const Address fromAddr = Account::GetAddressFromPublicKey(senderPubKey);
+    return UpdateAccounts(transaction,
+                          Account::GetAddressFromPublicKey(senderPubKey));
+}
+
+template<class MAP>
+bool AccountStoreBase<MAP>::UpdateAccounts(const Transaction& transaction,
+                                           const Address& fromAddr)
+{
     Address toAddr = transaction.GetToAddr();
     const uint256_t& amount = transaction.GetAmount();
 
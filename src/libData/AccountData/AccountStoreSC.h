@@ -21,12 +21,13 @@
 #include <mutex>
 
 #include "AccountStoreBase.h"
+#include "AddressMap.h"
 
 template<class MAP> class AccountStoreSC;
 
 template<class MAP>
 class AccountStoreAtomic
-    : public AccountStoreBase<unordered_map<Address, Account>>
+    : public AccountStoreBase<AddressMap<Account>>
 {
     AccountStoreSC<MAP>& m_parent;
 
@@ -35,7 +36,7 @@ public:
 
     Account* GetAccount(const Address& address) override;
 
-    const shared_ptr<unordered_map<Address, Account>>& GetAddressToAccount();
+    const shared_ptr<AddressMap<Account>>& GetAddressToAccount();
 };
 
 template<class MAP> class AccountStoreSC : public AccountStoreBase<MAP>
@@ -76,7 +76,7 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
             }
         }
 
-        return AccountStoreBase<MAP>::UpdateAccounts(transaction);
+        return AccountStoreBase<MAP>::UpdateAccounts(transaction, fromAddr);
     }
 
     bool callContract = false;
@@ -14,19 +14,81 @@
 * and which include a reference to GPLv3 in their program files.
 **/
 
+#include <atomic>
+#include <condition_variable>
+#include <numeric>
+
 #include "AccountStore.h"
+#include "libUtils/SafeMath.h"
+#include "libUtils/ThreadPool.h"
 
 using namespace std;
 
+namespace
+{
+    // Shorter runs are not worth grouping and handing over to other threads
+    const unsigned int PARALLEL_TRANSFER_MIN_BATCH = 32;
+
+    /// Normal transactions over a set of accounts no other group touches.
+    /// Existing accounts are updated in place in the temp store, while
+    /// accounts created along the way are kept here until the group is merged.
+    class TransferGroup : public AccountStoreBase<AddressMap<Account>>
+    {
+        AddressMap<Account*> m_attached;
+
+    public:
+        /// Positions in the batch and the sender of each, in batch order
+        vector<pair<unsigned int, Address>> m_txns;
+
+        void Attach(const Address& address, Account* account)
+        {
+            if (account != nullptr)
+            {
+                m_attached.emplace(address, account);
+            }
+        }
+
+        Account* GetAccount(const Address& address) override
+        {
+            auto it = m_attached.find(address);
+            if (it != m_attached.end())
+            {
+                return it->second;
+            }
+            return AccountStoreBase<AddressMap<Account>>::GetAccount(address);
+        }
+
+        const AddressMap<Account>& GetCreatedAccounts() const
+        {
+            return *m_addressToAccount;
+        }
+
+        void Run(const vector<Transaction>& txns,
+                 vector<unsigned char>& applied)
+        {
+            for (const auto& txn : m_txns)
+            {
+                applied.at(txn.first)
+                    = UpdateAccounts(txns.at(txn.first), txn.second);
+            }
+        }
+    };
+}
+
 AccountStoreTemp::AccountStoreTemp(AccountStore& parent)
     : m_parent(parent)
+    , m_transferPool(new ThreadPool(
+          max(thread::hardware_concurrency(), (unsigned int)2) - 1,
+          "TransferExec"))
 {
 }
 
+AccountStoreTemp::~AccountStoreTemp() {}
+
 Account* AccountStoreTemp::GetAccount(const Address& address)
 {
     Account* account
-        = AccountStoreBase<map<Address, Account>>::GetAccount(address);
+        = AccountStoreBase<AddressMap<Account>>::GetAccount(address);
     if (account != nullptr)
     {
         // LOG_GENERAL(INFO, "Got From Temp");
@@ -37,9 +99,8 @@ Account* AccountStoreTemp::GetAccount(const Address& address)
     if (account)
     {
         // LOG_GENERAL(INFO, "Got From Parent");
-        Account newaccount(*account);
-        m_addressToAccount->insert(make_pair(address, newaccount));
-        return &(m_addressToAccount->find(address))->second;
+        return &m_addressToAccount->insert(make_pair(address, *account))
+                    .first->second;
     }
 
     // LOG_GENERAL(INFO, "Got Nullptr");
@@ -47,7 +108,7 @@ Account* AccountStoreTemp::GetAccount(const Address& address)
     return nullptr;
 }
 
-const shared_ptr<map<Address, Account>>& AccountStoreTemp::GetAddressToAccount()
+const shared_ptr<AddressMap<Account>>& AccountStoreTemp::GetAddressToAccount()
 {
     return this->m_addressToAccount;
 }
@@ -111,4 +172,210 @@ int AccountStoreTemp::DeserializeDelta(const vector<unsigned char>& src,
         return -1;
     }
     return 0;
-}
\ No newline at end of file
+}
+void AccountStoreTemp::UpdateAccountsBatch(const uint64_t& blockNum,
+                                           const vector<Transaction>& txns,
+                                           vector<bool>& results)
+{
+    results.resize(txns.size(), true);
+
+    // Normal transactions only ever touch their sender and recipient, so
+    // every run of them between two contract transactions can be split up
+    // front into groups that cannot conflict. Contract transactions may touch
+    // anything and keep running one at a time in their place.
+    vector<unsigned int> transfers;
+    for (unsigned int i = 0; i < txns.size(); i++)
+    {
+        if (!results.at(i))
+        {
+            continue;
+        }
+
+        const Transaction& transaction = txns.at(i);
+        if (transaction.GetData().empty() && transaction.GetCode().empty())
+        {
+            transfers.emplace_back(i);
+            continue;
+        }
+
+        ApplyTransfers(blockNum, txns, transfers, results);
+        transfers.clear();
+
+        results.at(i) = UpdateAccounts(blockNum, transaction);
+    }
+
+    ApplyTransfers(blockNum, txns, transfers, results);
+}
+
+void AccountStoreTemp::RunConcurrently(const function<void()>& work,
+                                       unsigned int maxHelpers)
+{
+    mutex mutexPending;
+    condition_variable cvPending;
+    unsigned int pending
+        = min(maxHelpers, (unsigned int)m_transferPool->GetThreads().size());
+
+    for (unsigned int i = 0, helpers = pending; i < helpers; i++)
+    {
+        m_transferPool->AddJob([&work, &mutexPending, &cvPending, &pending]() {
+            work();
+
+            lock_guard<mutex> g(mutexPending);
+            if (--pending == 0)
+            {
+                cvPending.notify_one();
+            }
+        });
+    }
+
+    work();
+
+    unique_lock<mutex> g(mutexPending);
+    cvPending.wait(g, [&pending] { return pending == 0; });
+}
+
+void AccountStoreTemp::ApplyTransfers(const uint64_t& blockNum,
+                                      const vector<Transaction>& txns,
+                                      const vector<unsigned int>& indexes,
+                                      vector<bool>& results)
+{
+    if (indexes.size() < PARALLEL_TRANSFER_MIN_BATCH)
+    {
+        for (unsigned int index : indexes)
+        {
+            results.at(index) = UpdateAccounts(blockNum, txns.at(index));
+        }
+        return;
+    }
+
+    // Deriving the sender addresses is the costliest part of the preparation
+    // and needs no shared state, so it is spread over the pool first
+    const unsigned int count = indexes.size();
+    vector<Address> senders(count);
+    atomic<unsigned int> nextSender(0);
+    RunConcurrently(
+        [&txns, &indexes, &senders, &nextSender, count]() {
+            for (unsigned int pos = nextSender++; pos < count;
+                 pos = nextSender++)
+            {
+                senders.at(pos) = Account::GetAddressFromPublicKey(
+                    txns.at(indexes.at(pos)).GetSenderPubKey());
+            }
+        },
+        count / PARALLEL_TRANSFER_MIN_BATCH);
+
+    // Groups the transactions that share an account (union-find over their
+    // positions in the run). Every account is looked up here, in batch
+    // order, so the workers never have to insert into the map.
+    vector<unsigned int> root(count);
+    iota(root.begin(), root.end(), 0);
+    auto findRoot = [&root](unsigned int pos) {
+        while (root.at(pos) != pos)
+        {
+            root.at(pos) = root.at(root.at(pos));
+            pos = root.at(pos);
+        }
+        return pos;
+    };
+
+    vector<unsigned char> eligible(count, 0);
+    vector<pair<Account*, Account*>> touched(count, {nullptr, nullptr});
+    unordered_map<Address, unsigned int> owner;
+
+    for (unsigned int pos = 0; pos < count; pos++)
+    {
+        const Transaction& transaction = txns.at(indexes.at(pos));
+
+        // Same early rejection AccountStoreSC::UpdateAccounts makes before
+        // looking up any account
+        uint256_t gasDeposit;
+        if (!SafeMath<uint256_t>::mul(transaction.GetGasLimit(),
+                                      transaction.GetGasPrice(), gasDeposit))
+        {
+            results.at(indexes.at(pos)) = false;
+            continue;
+        }
+
+        // The recipient is looked up first and a contract recipient rejects
+        // the transaction before the sender is, exactly as in sequential
+        // execution, so no extra sender is pulled into the state delta.
+        // Only contract transactions create contracts, so the check holds
+        // for the whole run.
+        const Address& toAddr = transaction.GetToAddr();
+        touched.at(pos).first = GetAccount(toAddr);
+        if (touched.at(pos).first != nullptr
+            && touched.at(pos).first->isContract())
+        {
+            LOG_GENERAL(WARNING,
+                        "Contract account won't accept normal transaction");
+            results.at(indexes.at(pos)) = false;
+            continue;
+        }
+        touched.at(pos).second = GetAccount(senders.at(pos));
+        eligible.at(pos) = 1;
+
+        const Address* addresses[] = {&toAddr, &senders.at(pos)};
+        for (const Address* address : addresses)
+        {
+            auto it = owner.emplace(*address, pos);
+            if (!it.second)
+            {
+                root.at(findRoot(pos)) = findRoot(it.first->second);
+            }
+        }
+    }
+
+    // Groups are numbered by their first transaction so the merge below
+    // always happens in the same order
+    vector<unique_ptr<TransferGroup>> groups;
+    unordered_map<unsigned int, unsigned int> groupOfRoot;
+    for (unsigned int pos = 0; pos < count; pos++)
+    {
+        if (!eligible.at(pos))
+        {
+            continue;
+        }
+
+        auto it = groupOfRoot.emplace(findRoot(pos), groups.size());
+        if (it.second)
+        {
+            groups.emplace_back(new TransferGroup());
+        }
+
+        TransferGroup& group = *groups.at(it.first->second);
+        const Transaction& transaction = txns.at(indexes.at(pos));
+        group.m_txns.emplace_back(indexes.at(pos), senders.at(pos));
+        group.Attach(transaction.GetToAddr(), touched.at(pos).first);
+        group.Attach(senders.at(pos), touched.at(pos).second);
+    }
+
+    if (groups.empty())
+    {
+        return;
+    }
+
+    vector<unsigned char> applied(txns.size(), 0);
+    atomic<unsigned int> nextGroup(0);
+    RunConcurrently(
+        [&groups, &nextGroup, &txns, &applied]() {
+            for (unsigned int g = nextGroup++; g < groups.size();
+                 g = nextGroup++)
+            {
+                groups.at(g)->Run(txns, applied);
+            }
+        },
+        groups.size() - 1);
+
+    for (const auto& group : groups)
+    {
+        for (const auto& entry : group->GetCreatedAccounts())
+        {
+            m_addressToAccount->insert(entry);
+        }
+
+        for (const auto& txn : group->m_txns)
+        {
+            results.at(txn.first) = applied.at(txn.first);
+        }
+    }
+}
@@ -74,6 +74,8 @@ Account* AccountStoreTrie<DB, MAP>::GetAccount(const Address& address)
         // Storage Root
         it2.first->second.SetStorageRoot(accountDataRLP[2].toHash<h256>());
     }
+    // Freshly loaded from the trie, nothing to flush
+    it2.first->second.ClearDirty();
 
     return &it2.first->second;
 }
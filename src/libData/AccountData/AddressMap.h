@@ -0,0 +1,459 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+#ifndef __ADDRESSMAP_H__
+#define __ADDRESSMAP_H__
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Address.h"
+
+/**
+ * Open-addressing hash map keyed by Address, with linear probing.
+ * The table itself only holds the first 8 bytes of each address and the index of its
+ * entry, so a lookup scans contiguous memory and touches an entry only on a likely
+ * match. Entries are built in place in fixed-size chunks that are never moved, so
+ * pointers and references to values stay valid across inserts, as with the node-based
+ * standard containers. Iteration order is unspecified.
+ */
+template<class T> class AddressMap
+{
+public:
+    typedef Address key_type;
+    typedef T mapped_type;
+    typedef std::pair<const Address, T> value_type;
+
+private:
+    static const uint32_t EMPTY = UINT32_MAX;
+    static const uint32_t CHUNK_BITS = 6;
+    static const uint32_t CHUNK_SIZE = 1 << CHUNK_BITS;
+    static const unsigned int MIN_CAPACITY_BITS = 4;
+
+    struct Slot
+    {
+        uint64_t m_prefix;
+        uint32_t m_entry;
+    };
+
+    typedef typename std::aligned_storage<sizeof(value_type),
+                                          alignof(value_type)>::type Storage;
+
+    std::vector<Slot> m_slots;
+    unsigned int m_capacityBits;
+    size_t m_size;
+
+    std::vector<std::unique_ptr<Storage[]>> m_chunks;
+    uint32_t m_entriesUsed;
+    std::vector<uint32_t> m_freeEntries;
+
+    static uint64_t Prefix(const Address& key)
+    {
+        uint64_t prefix;
+        memcpy(&prefix, key.data(), sizeof(prefix));
+        return prefix;
+    }
+
+    template<class K>
+    using IsKey = std::is_same<typename std::decay<K>::type, Address>;
+
+    /// Finds the key among emplace arguments without building the entry, or
+    /// returns null for argument forms that only yield it once constructed.
+    template<class... Args> static const Address* KeyOf(const Args&...)
+    {
+        return nullptr;
+    }
+
+    template<class K, class M>
+    static typename std::enable_if<IsKey<K>::value, const Address*>::type
+    KeyOf(const std::pair<K, M>& value)
+    {
+        return &value.first;
+    }
+
+    template<class K, class M>
+    static typename std::enable_if<IsKey<K>::value, const Address*>::type
+    KeyOf(const K& key, const M&)
+    {
+        return &key;
+    }
+
+    template<class K, class... M>
+    static typename std::enable_if<IsKey<K>::value, const Address*>::type
+    KeyOf(std::piecewise_construct_t, const std::tuple<K>& key,
+          const std::tuple<M...>&)
+    {
+        return &std::get<0>(key);
+    }
+
+    /// Addresses are hash outputs already; the multiply only guards against
+    /// hand-made ones that differ in a few bytes.
+    size_t Home(uint64_t prefix) const
+    {
+        return (prefix * 0x9E3779B97F4A7C15ULL) >> (64 - m_capacityBits);
+    }
+
+    size_t Mask() const { return m_slots.size() - 1; }
+
+    value_type& Entry(uint32_t index)
+    {
+        return *reinterpret_cast<value_type*>(
+            &m_chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)]);
+    }
+
+    const value_type& Entry(uint32_t index) const
+    {
+        return *reinterpret_cast<const value_type*>(
+            &m_chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)]);
+    }
+
+    /// Returns the slot holding the key, or the table size if there is none.
+    size_t Find(const Address& key, uint64_t prefix) const
+    {
+        if (m_slots.empty())
+        {
+            return 0;
+        }
+
+        for (size_t pos = Home(prefix);; pos = (pos + 1) & Mask())
+        {
+            const Slot& slot = m_slots[pos];
+            if (slot.m_entry == EMPTY)
+            {
+                return m_slots.size();
+            }
+            if (slot.m_prefix == prefix && Entry(slot.m_entry).first == key)
+            {
+                return pos;
+            }
+        }
+    }
+
+    uint32_t AllocateEntry()
+    {
+        if (!m_freeEntries.empty())
+        {
+            uint32_t index = m_freeEntries.back();
+            m_freeEntries.pop_back();
+            return index;
+        }
+
+        if (m_entriesUsed == m_chunks.size() * CHUNK_SIZE)
+        {
+            m_chunks.emplace_back(new Storage[CHUNK_SIZE]);
+        }
+        return m_entriesUsed++;
+    }
+
+    /// Rebuilds the table with twice the slots; entries stay where they are.
+    void Grow()
+    {
+        std::vector<Slot> old;
+        old.swap(m_slots);
+
+        m_capacityBits = old.empty() ? MIN_CAPACITY_BITS : m_capacityBits + 1;
+        m_slots.assign(size_t(1) << m_capacityBits, Slot{0, EMPTY});
+
+        for (const Slot& slot : old)
+        {
+            if (slot.m_entry != EMPTY)
+            {
+                PlaceSlot(slot);
+            }
+        }
+    }
+
+    size_t PlaceSlot(const Slot& slot)
+    {
+        size_t pos = Home(slot.m_prefix);
+        while (m_slots[pos].m_entry != EMPTY)
+        {
+            pos = (pos + 1) & Mask();
+        }
+        m_slots[pos] = slot;
+        return pos;
+    }
+
+    /// Adds a slot for a new entry, keeping the table at most 3/4 full.
+    size_t AddSlot(uint64_t prefix, uint32_t index)
+    {
+        if ((m_size + 1) * 4 > m_slots.size() * 3)
+        {
+            Grow();
+        }
+        m_size++;
+        return PlaceSlot(Slot{prefix, index});
+    }
+
+    template<class... Args> uint32_t ConstructEntry(Args&&... args)
+    {
+        uint32_t index = AllocateEntry();
+        try
+        {
+            new (&Entry(index)) value_type(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            m_freeEntries.push_back(index);
+            throw;
+        }
+        return index;
+    }
+
+    void DestroyEntry(uint32_t index)
+    {
+        Entry(index).~value_type();
+        m_freeEntries.push_back(index);
+    }
+
+    /// Removes a slot and shifts the following ones back, so no tombstones are needed.
+    void RemoveSlot(size_t hole)
+    {
+        for (size_t next = (hole + 1) & Mask(); m_slots[next].m_entry != EMPTY;
+             next = (next + 1) & Mask())
+        {
+            const size_t home = Home(m_slots[next].m_prefix);
+            if (((next - home) & Mask()) >= ((next - hole) & Mask()))
+            {
+                m_slots[hole] = m_slots[next];
+                hole = next;
+            }
+        }
+        m_slots[hole].m_entry = EMPTY;
+        m_size--;
+    }
+
+    template<bool IsConst> class Iterator
+    {
+        friend class AddressMap;
+        template<bool> friend class Iterator;
+
+        typedef typename std::conditional<IsConst, const AddressMap,
+                                          AddressMap>::type Map;
+
+        Map* m_map;
+        size_t m_pos;
+
+        Iterator(Map* map, size_t pos)
+            : m_map(map)
+            , m_pos(pos)
+        {
+            while (m_pos < m_map->m_slots.size()
+                   && m_map->m_slots[m_pos].m_entry == EMPTY)
+            {
+                m_pos++;
+            }
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename AddressMap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<IsConst, const value_type*,
+                                          value_type*>::type pointer;
+        typedef typename std::conditional<IsConst, const value_type&,
+                                          value_type&>::type reference;
+
+        Iterator()
+            : m_map(nullptr)
+            , m_pos(0)
+        {
+        }
+
+        /// Allows iterator to const_iterator conversion.
+        template<bool WasConst,
+                 class = typename std::enable_if<IsConst && !WasConst>::type>
+        Iterator(const Iterator<WasConst>& other)
+            : m_map(other.m_map)
+            , m_pos(other.m_pos)
+        {
+        }
+
+        reference operator*() const
+        {
+            return m_map->Entry(m_map->m_slots[m_pos].m_entry);
+        }
+
+        pointer operator->() const { return &**this; }
+
+        Iterator& operator++()
+        {
+            *this = Iterator(m_map, m_pos + 1);
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return m_pos == other.m_pos && m_map == other.m_map;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+public:
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    AddressMap()
+        : m_capacityBits(0)
+        , m_size(0)
+        , m_entriesUsed(0)
+    {
+    }
+
+    ~AddressMap() { clear(); }
+
+    AddressMap(const AddressMap&) = delete;
+    AddressMap& operator=(const AddressMap&) = delete;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_slots.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_slots.size()); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    iterator find(const Address& key)
+    {
+        return iterator(this, Find(key, Prefix(key)));
+    }
+
+    const_iterator find(const Address& key) const
+    {
+        return const_iterator(this, Find(key, Prefix(key)));
+    }
+
+    size_t count(const Address& key) const
+    {
+        return Find(key, Prefix(key)) != m_slots.size() ? 1 : 0;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return emplace(value);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        return emplace(std::move(value));
+    }
+
+    template<class P> std::pair<iterator, bool> insert(P&& value)
+    {
+        return emplace(std::forward<P>(value));
+    }
+
+    /// Looks the key up before building anything, so a hit constructs no entry.
+    template<class... Args> std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        const Address* key = KeyOf(args...);
+        if (key != nullptr)
+        {
+            const uint64_t prefix = Prefix(*key);
+            size_t pos = Find(*key, prefix);
+            if (pos != m_slots.size())
+            {
+                return {iterator(this, pos), false};
+            }
+
+            uint32_t index = ConstructEntry(std::forward<Args>(args)...);
+            return {iterator(this, AddSlot(prefix, index)), true};
+        }
+
+        // Otherwise the key is only known once the entry is built
+        uint32_t index = ConstructEntry(std::forward<Args>(args)...);
+        const uint64_t prefix = Prefix(Entry(index).first);
+
+        size_t pos = Find(Entry(index).first, prefix);
+        if (pos != m_slots.size())
+        {
+            DestroyEntry(index);
+            return {iterator(this, pos), false};
+        }
+
+        return {iterator(this, AddSlot(prefix, index)), true};
+    }
+
+    T& operator[](const Address& key)
+    {
+        const uint64_t prefix = Prefix(key);
+        size_t pos = Find(key, prefix);
+        if (pos == m_slots.size())
+        {
+            uint32_t index = ConstructEntry(std::piecewise_construct,
+                                            std::forward_as_tuple(key),
+                                            std::forward_as_tuple());
+            pos = AddSlot(prefix, index);
+        }
+        return Entry(m_slots[pos].m_entry).second;
+    }
+
+    size_t erase(const Address& key)
+    {
+        size_t pos = Find(key, Prefix(key));
+        if (pos == m_slots.size())
+        {
+            return 0;
+        }
+
+        DestroyEntry(m_slots[pos].m_entry);
+        RemoveSlot(pos);
+        return 1;
+    }
+
+    /// Unlike the standard containers, returns nothing: later entries may be
+    /// shifted back into the erased slot.
+    void erase(const_iterator it)
+    {
+        DestroyEntry(m_slots[it.m_pos].m_entry);
+        RemoveSlot(it.m_pos);
+    }
+
+    /// Destroys all entries but keeps the memory for reuse.
+    void clear()
+    {
+        for (Slot& slot : m_slots)
+        {
+            if (slot.m_entry != EMPTY)
+            {
+                Entry(slot.m_entry).~value_type();
+                slot.m_entry = EMPTY;
+            }
+        }
+        m_size = 0;
+        m_entriesUsed = 0;
+        m_freeEntries.clear();
+    }
+};
+
+#endif // __ADDRESSMAP_H__
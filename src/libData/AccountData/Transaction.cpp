@@ -114,13 +114,7 @@ Transaction::Transaction(uint256_t version, const uint256_t& nonce,
     // Generate the transaction ID
     SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
     sha2.Update(txnData);
-    const vector<unsigned char>& output = sha2.Finalize();
-    if (output.size() != TRAN_HASH_SIZE)
-    {
-        LOG_GENERAL(WARNING, "We failed to generate m_tranID.");
-        return;
-    }
-    copy(output.begin(), output.end(), m_tranID.asArray().begin());
+    sha2.Finalize(m_tranID.asArray());
 
     // Generate the signature
     if (Schnorr::GetInstance().Sign(txnData, senderKeyPair.first,
@@ -155,13 +149,7 @@ Transaction::Transaction(uint256_t version, const uint256_t& nonce,
     // Generate the transaction ID
     SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
     sha2.Update(txnData);
-    const vector<unsigned char>& output = sha2.Finalize();
-    if (output.size() != TRAN_HASH_SIZE)
-    {
-        LOG_GENERAL(WARNING, "We failed to generate m_tranID.");
-        return;
-    }
-    copy(output.begin(), output.end(), m_tranID.asArray().begin());
+    sha2.Finalize(m_tranID.asArray());
 
     // Verify the signature
     if (Schnorr::GetInstance().Verify(txnData, m_signature, m_senderPubKey)
@@ -27,6 +27,7 @@
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
 #include "libCrypto/Sha2.h"
+#include "libCrypto/Sha2Batch.h"
 #include "libMediator/Mediator.h"
 #include "libNetwork/P2PComm.h"
 #include "libUtils/DataConversion.h"
@@ -52,8 +53,7 @@ void DirectoryService::ComposeDSBlock()
         const DSBlockHeader& lastHeader = lastBlock.GetHeader();
         lastHeader.Serialize(vec, 0);
         sha2.Update(vec);
-        const vector<unsigned char>& resVec = sha2.Finalize();
-        copy(resVec.begin(), resVec.end(), prevHash.asArray().begin());
+        sha2.Finalize(prevHash.asArray());
     }
 
     // Assemble DS block header
@@ -119,24 +119,32 @@ void DirectoryService::ComputeSharding()
         m_shards.emplace_back();
     }
 
-    map<array<unsigned char, BLOCK_HASH_SIZE>, PubKey> sortedPoWs;
+    // sort all PoW submissions according to H(nonce, pubkey),
+    // hashing all of them in one batch
+    const unsigned int entrySize = POW_SIZE + PUB_KEY_SIZE;
+    vector<unsigned char> hashVec(m_allPoWs.size() * entrySize);
+    vector<ByteSpan> hashInputs;
+    hashInputs.reserve(m_allPoWs.size());
 
+    unsigned int curr_offset = 0;
     for (const auto& kv : m_allPoWs)
     {
-        const PubKey& key = kv.first;
-        const uint256_t& nonce = kv.second;
+        Serializable::SetNumber<uint256_t>(hashVec, curr_offset, kv.second,
+                                           UINT256_SIZE);
+        kv.first.Serialize(hashVec, curr_offset + POW_SIZE);
+        hashInputs.emplace_back(hashVec.data() + curr_offset, entrySize);
+        curr_offset += entrySize;
+    }
 
-        // sort all PoW submissions according to H(nonce, pubkey)
-        SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
-        vector<unsigned char> hashVec;
-        hashVec.resize(POW_SIZE + PUB_KEY_SIZE);
-        Serializable::SetNumber<uint256_t>(hashVec, 0, nonce, UINT256_SIZE);
-        key.Serialize(hashVec, POW_SIZE);
-        sha2.Update(hashVec);
-        const vector<unsigned char>& sortHashVec = sha2.Finalize();
-        array<unsigned char, BLOCK_HASH_SIZE> sortHash;
-        copy(sortHashVec.begin(), sortHashVec.end(), sortHash.begin());
-        sortedPoWs.emplace(sortHash, key);
+    vector<SHA256Batch::Digest> sortHashes;
+    SHA256Batch::Hash(hashInputs, sortHashes);
+
+    map<array<unsigned char, BLOCK_HASH_SIZE>, PubKey> sortedPoWs;
+
+    unsigned int j = 0;
+    for (const auto& kv : m_allPoWs)
+    {
+        sortedPoWs.emplace(sortHashes.at(j++), kv.first);
     }
 
     unsigned int i = 0;
@@ -549,7 +549,12 @@ bool DirectoryService::ProcessFinalBlockConsensus(
         return false;
     }
 
-    lock_guard<mutex> g(m_mutexConsensus);
+    std::unique_lock<mutex> g(m_mutexConsensus, std::defer_lock);
+    if (!ConsensusCommon::PreProcessInOrder(cv_lk, g, m_consensusObject,
+                                            message, offset, from))
+    {
+        return false;
+    }
 
     if (!m_consensusObject->ProcessMessage(message, offset, from))
     {
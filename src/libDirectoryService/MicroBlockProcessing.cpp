@@ -62,9 +62,9 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
     vector<PubKey> keys;
     for (auto& kv : shard)
     {
+        keys.emplace_back(kv.first);
         if (B2.at(index) == true)
         {
-            keys.emplace_back(kv.first);
             count++;
         }
         index++;
@@ -76,7 +76,7 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
         return false;
     }
 
-    shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+    shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys, B2);
     if (aggregatedKey == nullptr)
     {
         LOG_GENERAL(WARNING, "Aggregated key generation failed");
@@ -94,9 +94,12 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
         == false)
     {
         LOG_GENERAL(WARNING, "Cosig verification failed");
-        for (auto& kv : keys)
+        for (unsigned int i = 0; i < keys.size(); i++)
         {
-            LOG_GENERAL(WARNING, kv);
+            if (B2.at(i) == true)
+            {
+                LOG_GENERAL(WARNING, keys.at(i));
+            }
         }
         return false;
     }
@@ -123,19 +123,20 @@ void DirectoryService::ProcessViewChangeConsensusWhenDone()
     unsigned int index = 0;
     unsigned int count = 0;
 
+    const vector<bool>& B2 = m_pendingVCBlock->GetB2();
     vector<PubKey> keys;
     for (auto const& kv : *m_mediator.m_DSCommittee)
     {
-        if (m_pendingVCBlock->GetB2().at(index) == true)
+        keys.emplace_back(kv.first);
+        if (B2.at(index) == true)
         {
-            keys.emplace_back(kv.first);
             count++;
         }
         index++;
     }
 
     // Verify cosig against vcblock
-    shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+    shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys, B2);
     if (aggregatedKey == nullptr)
     {
         LOG_GENERAL(WARNING, "Aggregated key generation failed");
@@ -151,9 +152,12 @@ void DirectoryService::ProcessViewChangeConsensusWhenDone()
                                           *aggregatedKey))
     {
         LOG_GENERAL(WARNING, "cosig verification fail");
-        for (auto& kv : keys)
+        for (unsigned int i = 0; i < keys.size(); i++)
         {
-            LOG_GENERAL(WARNING, kv);
+            if (B2.at(i) == true)
+            {
+                LOG_GENERAL(WARNING, keys.at(i));
+            }
         }
         return;
     }
@@ -464,7 +468,13 @@ bool DirectoryService::ProcessViewChangeConsensus(
         return false;
     }
 
-    lock_guard<mutex> g(m_mutexConsensus);
+    std::unique_lock<mutex> g(m_mutexConsensus, std::defer_lock);
+    if (!ConsensusCommon::PreProcessInOrder(cv_lk_con_msg, g,
+                                            m_consensusObject, message, offset,
+                                            from))
+    {
+        return false;
+    }
 
     if (!m_consensusObject->ProcessMessage(message, offset, from))
     {
@@ -0,0 +1,212 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <algorithm>
+#include <cstring>
+
+#include "BroadcastHashStore.h"
+
+using namespace std;
+
+// The keys are SHA-256 digests, so any of their bytes are already uniformly distributed.
+// Bloom indices, shard choice and bucket hash each read a different slice of the key.
+
+size_t BroadcastHashStore::KeyHash::operator()(const Key& key) const
+{
+    size_t h;
+    memcpy(&h, key.data() + 16, sizeof(h));
+    return h;
+}
+
+BroadcastHashStore::BroadcastHashStore(chrono::milliseconds tickDuration,
+                                       unsigned int numSlots,
+                                       bool useBloomFilter)
+    : m_start(Clock::now())
+    , m_tickDuration(max(tickDuration, chrono::milliseconds(1)))
+    , m_numSlots(max(numSlots, 2u))
+{
+    for (auto& shard : m_shards)
+    {
+        shard.m_wheel.resize(m_numSlots);
+        shard.m_tick = 0;
+    }
+
+    if (useBloomFilter)
+    {
+        m_bloom.reset(new atomic<uint8_t>[BLOOM_COUNTERS]);
+        for (unsigned int i = 0; i < BLOOM_COUNTERS; i++)
+        {
+            m_bloom[i].store(0, memory_order_relaxed);
+        }
+    }
+}
+
+BroadcastHashStore::~BroadcastHashStore() {}
+
+uint64_t BroadcastHashStore::CurrentTick() const
+{
+    return (Clock::now() - m_start) / m_tickDuration;
+}
+
+BroadcastHashStore::Shard& BroadcastHashStore::ShardOf(const Key& key)
+{
+    return m_shards[key[HASH_SIZE - 1] % NUM_SHARDS];
+}
+
+void BroadcastHashStore::Advance(Shard& shard, uint64_t tick)
+{
+    if (tick <= shard.m_tick)
+    {
+        return;
+    }
+
+    // Sweep every slot that has come around again since the last access, at most one full turn
+    uint64_t last = min(tick, shard.m_tick + m_numSlots);
+    for (uint64_t t = shard.m_tick + 1; t <= last; t++)
+    {
+        auto& bucket = shard.m_wheel[t % m_numSlots];
+        for (const auto& key : bucket)
+        {
+            shard.m_keys.erase(key);
+            BloomRemove(key);
+        }
+        bucket.clear();
+    }
+
+    shard.m_tick = tick;
+}
+
+unsigned int BroadcastHashStore::BloomIndex(const Key& key, unsigned int i)
+{
+    uint32_t index;
+    memcpy(&index, key.data() + i * sizeof(index), sizeof(index));
+    return index % BLOOM_COUNTERS;
+}
+
+bool BroadcastHashStore::BloomMayContain(const Key& key) const
+{
+    for (unsigned int i = 0; i < BLOOM_HASHES; i++)
+    {
+        if (m_bloom[BloomIndex(key, i)].load(memory_order_acquire) == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BroadcastHashStore::BloomAdd(const Key& key)
+{
+    if (!m_bloom)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < BLOOM_HASHES; i++)
+    {
+        auto& counter = m_bloom[BloomIndex(key, i)];
+        uint8_t value = counter.load(memory_order_relaxed);
+        // A saturated counter sticks, it can no longer be decremented safely
+        while (value < UINT8_MAX
+               && !counter.compare_exchange_weak(value, value + 1,
+                                                 memory_order_release,
+                                                 memory_order_relaxed))
+        {
+        }
+    }
+}
+
+void BroadcastHashStore::BloomRemove(const Key& key)
+{
+    if (!m_bloom)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < BLOOM_HASHES; i++)
+    {
+        auto& counter = m_bloom[BloomIndex(key, i)];
+        uint8_t value = counter.load(memory_order_relaxed);
+        while (value > 0 && value < UINT8_MAX
+               && !counter.compare_exchange_weak(value, value - 1,
+                                                 memory_order_relaxed))
+        {
+        }
+    }
+}
+
+bool BroadcastHashStore::ToKey(const vector<unsigned char>& hash, Key& key)
+{
+    if (hash.size() != HASH_SIZE)
+    {
+        return false;
+    }
+
+    copy(hash.begin(), hash.end(), key.begin());
+    return true;
+}
+
+bool BroadcastHashStore::Contains(const vector<unsigned char>& hash)
+{
+    Key key;
+    if (!ToKey(hash, key))
+    {
+        return false;
+    }
+
+    if (m_bloom && !BloomMayContain(key))
+    {
+        return false;
+    }
+
+    Shard& shard = ShardOf(key);
+    lock_guard<mutex> g(shard.m_mutex);
+    Advance(shard, CurrentTick());
+    return shard.m_keys.find(key) != shard.m_keys.end();
+}
+
+bool BroadcastHashStore::Insert(const vector<unsigned char>& hash)
+{
+    Key key;
+    if (!ToKey(hash, key))
+    {
+        return false;
+    }
+
+    Shard& shard = ShardOf(key);
+    lock_guard<mutex> g(shard.m_mutex);
+    Advance(shard, CurrentTick());
+
+    if (!shard.m_keys.insert(key).second)
+    {
+        return false;
+    }
+
+    shard.m_wheel[shard.m_tick % m_numSlots].emplace_back(key);
+    BloomAdd(key);
+    return true;
+}
+
+size_t BroadcastHashStore::Size()
+{
+    size_t size = 0;
+    for (auto& shard : m_shards)
+    {
+        lock_guard<mutex> g(shard.m_mutex);
+        size += shard.m_keys.size();
+    }
+    return size;
+}
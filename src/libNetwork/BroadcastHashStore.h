@@ -0,0 +1,92 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#ifndef __BROADCASTHASHSTORE_H__
+#define __BROADCASTHASHSTORE_H__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+/// Concurrent set of recently seen broadcast hashes that forgets each hash after a fixed lifetime.
+class BroadcastHashStore
+{
+public:
+    static const unsigned int HASH_SIZE = 32;
+    using Key = std::array<unsigned char, HASH_SIZE>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static const unsigned int NUM_SHARDS = 64;
+    static const unsigned int BLOOM_COUNTERS = 1 << 20;
+    static const unsigned int BLOOM_HASHES = 4;
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    /// Each shard owns its own time wheel, so expiry never takes more than one shard lock.
+    struct Shard
+    {
+        std::mutex m_mutex;
+        std::unordered_set<Key, KeyHash> m_keys;
+        std::vector<std::vector<Key>> m_wheel;
+        uint64_t m_tick;
+    };
+
+    const Clock::time_point m_start;
+    const Clock::duration m_tickDuration;
+    const unsigned int m_numSlots;
+    std::array<Shard, NUM_SHARDS> m_shards;
+    std::unique_ptr<std::atomic<uint8_t>[]> m_bloom;
+
+    uint64_t CurrentTick() const;
+    Shard& ShardOf(const Key& key);
+    void Advance(Shard& shard, uint64_t tick);
+
+    static unsigned int BloomIndex(const Key& key, unsigned int i);
+    bool BloomMayContain(const Key& key) const;
+    void BloomAdd(const Key& key);
+    void BloomRemove(const Key& key);
+
+    static bool ToKey(const std::vector<unsigned char>& hash, Key& key);
+
+public:
+    /// Keeps each hash for at least (numSlots - 1) and at most numSlots ticks.
+    BroadcastHashStore(std::chrono::milliseconds tickDuration,
+                       unsigned int numSlots, bool useBloomFilter);
+    ~BroadcastHashStore();
+
+    BroadcastHashStore(BroadcastHashStore const&) = delete;
+    void operator=(BroadcastHashStore const&) = delete;
+
+    /// Returns true if the hash was seen recently; a Bloom filter miss answers without locking.
+    bool Contains(const std::vector<unsigned char>& hash);
+
+    /// Adds the hash, returning false if it was already present (i.e., the message is a duplicate).
+    bool Insert(const std::vector<unsigned char>& hash);
+
+    /// Returns the number of stored hashes, including expired ones not yet swept.
+    size_t Size();
+};
+
+#endif // __BROADCASTHASHSTORE_H__
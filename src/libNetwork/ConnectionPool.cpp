@@ -0,0 +1,298 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <algorithm>
+#include <cstring>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "ConnectionPool.h"
+#include "common/Constants.h"
+#include "libUtils/DetachedFunction.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+ConnectionPool::Connection::Connection(int cli_sock)
+    : m_socket(cli_sock)
+    , m_broken(false)
+    , m_lastUsed(Clock::now())
+{
+}
+
+ConnectionPool::Connection::~Connection()
+{
+    shutdown(m_socket, SHUT_RDWR);
+    close(m_socket);
+}
+
+ConnectionPool::ConnectionPool()
+{
+    auto func = [this]() -> void {
+        while (true)
+        {
+            this_thread::sleep_for(chrono::seconds(
+                max(CONNECTION_IDLE_TIMEOUT_IN_SECONDS / 2, 1u)));
+            EvictIdleConnections();
+        }
+    };
+
+    DetachedFunction(1, func);
+}
+
+ConnectionPool::~ConnectionPool() {}
+
+ConnectionPool& ConnectionPool::GetInstance()
+{
+    static ConnectionPool pool;
+    return pool;
+}
+
+int ConnectionPool::Connect(const Peer& peer)
+{
+    int cli_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (cli_sock < 0)
+    {
+        LOG_GENERAL(WARNING,
+                    "Socket creation failed. Code = "
+                        << errno << " Desc: " << std::strerror(errno)
+                        << ". IP address: " << peer);
+        return -1;
+    }
+
+    // Consensus messages are small and latency-bound, don't let Nagle hold them back
+    int enable = 1;
+    setsockopt(cli_sock, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+    struct sockaddr_in serv_addr;
+    memset(&serv_addr, 0, sizeof(struct sockaddr_in));
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_addr.s_addr = peer.m_ipAddress.convert_to<unsigned long>();
+    serv_addr.sin_port = htons(peer.m_listenPortHost);
+
+    if (connect(cli_sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0)
+    {
+        LOG_GENERAL(WARNING,
+                    "Socket connect failed. Code = "
+                        << errno << " Desc: " << std::strerror(errno)
+                        << ". IP address: " << peer);
+        close(cli_sock);
+        return -1;
+    }
+
+    return cli_sock;
+}
+
+bool ConnectionPool::IsAlive(int cli_sock)
+{
+    // The remote end never writes back on this connection, so any readable
+    // event means it has been closed or reset.
+    struct pollfd pfd;
+    pfd.fd = cli_sock;
+    pfd.events = POLLIN | POLLRDHUP;
+    pfd.revents = 0;
+
+    return poll(&pfd, 1, 0) == 0;
+}
+
+shared_ptr<ConnectionPool::Connection>
+ConnectionPool::GetConnection(const Peer& peer)
+{
+    {
+        lock_guard<mutex> g(m_mutexConnections);
+
+        auto it = m_connections.find(peer);
+        if (it != m_connections.end())
+        {
+            if (!it->second->m_broken && IsAlive(it->second->m_socket))
+            {
+                return it->second;
+            }
+
+            LOG_GENERAL(INFO, "Connection to " << peer << " went stale");
+            m_connections.erase(it);
+        }
+
+        auto backoff = m_backoff.find(peer);
+        if (backoff != m_backoff.end()
+            && Clock::now() < backoff->second.m_retryAfter)
+        {
+            LOG_GENERAL(INFO,
+                        "Still backing off from " << peer << " after "
+                                                  << backoff->second.m_failures
+                                                  << " failed connects");
+            return nullptr;
+        }
+    }
+
+    // Connect outside the lock so that one slow peer doesn't stall the others
+    int cli_sock = Connect(peer);
+
+    lock_guard<mutex> g(m_mutexConnections);
+
+    if (cli_sock < 0)
+    {
+        Backoff& backoff = m_backoff[peer];
+        backoff.m_failures++;
+        unsigned int delay = RECONNECT_BACKOFF_BASE_IN_MS
+            << min(backoff.m_failures - 1, 16u);
+        delay = min(delay, RECONNECT_BACKOFF_MAX_IN_MS)
+            + rand() % max(RECONNECT_BACKOFF_BASE_IN_MS, 1u);
+        backoff.m_retryAfter = Clock::now() + chrono::milliseconds(delay);
+        return nullptr;
+    }
+
+    m_backoff.erase(peer);
+    auto conn = make_shared<Connection>(cli_sock);
+
+    auto it = m_connections.find(peer);
+    if (it != m_connections.end())
+    {
+        // Another sender connected to this peer in the meantime, use that one
+        return it->second;
+    }
+
+    if (m_connections.size() >= MAX_PEER_CONNECTIONS
+        && !EvictLeastRecentlyUsed())
+    {
+        LOG_GENERAL(WARNING,
+                    "Connection pool full (" << m_connections.size()
+                                             << "), not keeping connection to "
+                                             << peer);
+        return conn;
+    }
+
+    m_connections.emplace(peer, conn);
+    return conn;
+}
+
+void ConnectionPool::DropConnection(const Peer& peer,
+                                    const shared_ptr<Connection>& conn)
+{
+    lock_guard<mutex> g(m_mutexConnections);
+
+    auto it = m_connections.find(peer);
+    if (it != m_connections.end() && it->second == conn)
+    {
+        m_connections.erase(it);
+    }
+}
+
+bool ConnectionPool::EvictLeastRecentlyUsed()
+{
+    auto victim = m_connections.end();
+    Clock::time_point oldest = Clock::time_point::max();
+
+    for (auto it = m_connections.begin(); it != m_connections.end(); ++it)
+    {
+        // Skip connections that are busy writing
+        unique_lock<mutex> g(it->second->m_mutexWrite, try_to_lock);
+        if (g.owns_lock() && it->second->m_lastUsed < oldest)
+        {
+            oldest = it->second->m_lastUsed;
+            victim = it;
+        }
+    }
+
+    if (victim == m_connections.end())
+    {
+        return false;
+    }
+
+    m_connections.erase(victim);
+    return true;
+}
+
+void ConnectionPool::EvictIdleConnections()
+{
+    lock_guard<mutex> g(m_mutexConnections);
+
+    const Clock::time_point now = Clock::now();
+    const Clock::time_point idleLimit
+        = now - chrono::seconds(CONNECTION_IDLE_TIMEOUT_IN_SECONDS);
+
+    for (auto it = m_connections.begin(); it != m_connections.end();)
+    {
+        unique_lock<mutex> g2(it->second->m_mutexWrite, try_to_lock);
+        if (g2.owns_lock()
+            && (it->second->m_broken || it->second->m_lastUsed < idleLimit))
+        {
+            g2.unlock();
+            it = m_connections.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (auto it = m_backoff.begin(); it != m_backoff.end();)
+    {
+        if (it->second.m_retryAfter < idleLimit)
+        {
+            it = m_backoff.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool ConnectionPool::Send(const Peer& peer, const FrameWriter& writer)
+{
+    shared_ptr<Connection> conn = GetConnection(peer);
+    if (conn == nullptr)
+    {
+        return false;
+    }
+
+    bool result = false;
+    {
+        lock_guard<mutex> g(conn->m_mutexWrite);
+
+        // A concurrent sender may have broken the stream while we waited
+        if (!conn->m_broken)
+        {
+            result = writer(conn->m_socket);
+            conn->m_lastUsed = Clock::now();
+            conn->m_broken = !result;
+        }
+    }
+
+    if (!result)
+    {
+        DropConnection(peer, conn);
+    }
+
+    return result;
+}
+
+void ConnectionPool::Remove(const Peer& peer)
+{
+    lock_guard<mutex> g(m_mutexConnections);
+    m_connections.erase(peer);
+}
+
+size_t ConnectionPool::Size()
+{
+    lock_guard<mutex> g(m_mutexConnections);
+    return m_connections.size();
+}
@@ -0,0 +1,91 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#ifndef __CONNECTIONPOOL_H__
+#define __CONNECTIONPOOL_H__
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Peer.h"
+
+/// Keeps long-lived outbound connections (one per peer) so that many framed messages can share the same socket.
+class ConnectionPool
+{
+public:
+    /// Writes one complete frame to the socket and returns false if the frame was not fully written.
+    using FrameWriter = std::function<bool(int cli_sock)>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection
+    {
+        int m_socket;
+        std::atomic<bool> m_broken;
+        std::mutex m_mutexWrite;
+        Clock::time_point m_lastUsed;
+
+        explicit Connection(int cli_sock);
+        ~Connection();
+    };
+
+    struct Backoff
+    {
+        unsigned int m_failures;
+        Clock::time_point m_retryAfter;
+    };
+
+    std::mutex m_mutexConnections;
+    std::unordered_map<Peer, std::shared_ptr<Connection>> m_connections;
+    std::unordered_map<Peer, Backoff> m_backoff;
+
+    ConnectionPool();
+    ~ConnectionPool();
+
+    // Singleton should not implement these
+    ConnectionPool(ConnectionPool const&) = delete;
+    void operator=(ConnectionPool const&) = delete;
+
+    std::shared_ptr<Connection> GetConnection(const Peer& peer);
+    void DropConnection(const Peer& peer,
+                        const std::shared_ptr<Connection>& conn);
+    bool EvictLeastRecentlyUsed();
+    void EvictIdleConnections();
+    static bool IsAlive(int cli_sock);
+
+public:
+    /// Returns the singleton ConnectionPool instance.
+    static ConnectionPool& GetInstance();
+
+    /// Opens a new blocking TCP connection to the peer, or returns -1 on failure.
+    static int Connect(const Peer& peer);
+
+    /// Sends one frame to the peer over its pooled connection, (re)connecting if needed.
+    bool Send(const Peer& peer, const FrameWriter& writer);
+
+    /// Closes the pooled connection to the peer, if any.
+    void Remove(const Peer& peer);
+
+    /// Returns the number of currently pooled connections.
+    size_t Size();
+};
+
+#endif // __CONNECTIONPOOL_H__
@@ -0,0 +1,436 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <algorithm>
+
+#include "Gossip.h"
+#include "P2PComm.h"
+#include "common/Constants.h"
+#include "common/Messages.h"
+#include "common/Serializable.h"
+#include "libCrypto/Sha2.h"
+#include "libUtils/DetachedFunction.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+Gossip::Gossip()
+    : m_sender([](const vector<Peer>& peers, const SharedBuffer& frame) {
+        P2PComm::GetInstance().SendGossipMessage(peers, frame);
+    })
+{
+    // Without any gossiped instruction there is nothing to push or digest
+    if (!BROADCAST_GOSSIP_MODE)
+    {
+        return;
+    }
+
+    auto func = [this]() -> void {
+        unsigned int round = 0;
+
+        while (true)
+        {
+            this_thread::sleep_for(
+                chrono::milliseconds(GOSSIP_ROUND_INTERVAL_IN_MS));
+            RunRound();
+
+            if (++round % STATS_ROUNDS == 0)
+            {
+                LogStats();
+            }
+        }
+    };
+
+    DetachedFunction(1, func);
+}
+
+Gossip::~Gossip() {}
+
+Gossip& Gossip::GetInstance()
+{
+    static Gossip gossip;
+    return gossip;
+}
+
+uint64_t Gossip::NowInMs()
+{
+    return chrono::duration_cast<chrono::milliseconds>(
+               chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+vector<Peer> Gossip::PickPeers(const vector<Peer>& peers, unsigned int count)
+{
+    vector<Peer> picked(peers);
+
+    if (picked.size() > count)
+    {
+        for (unsigned int i = 0; i < count; i++)
+        {
+            swap(picked.at(i), picked.at(i + rand() % (picked.size() - i)));
+        }
+        picked.resize(count);
+    }
+
+    return picked;
+}
+
+vector<unsigned char>
+Gossip::MakeHashList(Type type, const vector<vector<unsigned char>>& hashes)
+{
+    vector<unsigned char> frame = {type};
+    Serializable::SetNumber<uint32_t>(
+        frame, TYPE_LEN, P2PComm::GetInstance().GetSelfPeer().m_listenPortHost,
+        PORT_LEN);
+
+    for (const auto& hash : hashes)
+    {
+        frame.insert(frame.end(), hash.begin(), hash.end());
+    }
+
+    return frame;
+}
+
+void Gossip::Send(const vector<Peer>& peers, const SharedBuffer& frame)
+{
+    if (peers.empty())
+    {
+        return;
+    }
+
+    m_gossipBytes += frame->size() * peers.size();
+    m_sender(peers, frame);
+}
+
+bool Gossip::StoreRumor(const vector<unsigned char>& hash, Rumor&& rumor)
+{
+    // m_mutexRumors is held by the caller. Expiring here rather than in
+    // RunRound keeps the store bounded even when no rounds are run
+    const Clock::time_point now = rumor.m_received;
+    while (!m_arrivals.empty()
+           && now - m_arrivals.front().first
+               > chrono::seconds(BROADCAST_EXPIRY))
+    {
+        // Hashes stay around as long as flooded ones do to reject late copies
+        m_rumors.erase(m_arrivals.front().second);
+        m_arrivals.pop_front();
+    }
+
+    if (!m_rumors.emplace(hash, move(rumor)).second)
+    {
+        return false;
+    }
+
+    m_arrivals.emplace_back(now, hash);
+    return true;
+}
+
+void Gossip::SpreadRumor(const vector<Peer>& peers,
+                         const vector<unsigned char>& message)
+{
+    LOG_MARKER();
+
+    SHA2<HASH_TYPE::HASH_VARIANT_256> sha256;
+    sha256.Update(message);
+    const vector<unsigned char> hash = sha256.Finalize();
+
+    vector<unsigned char> frame = {PUSH};
+    frame.reserve(PUSH_HDR_LEN + message.size());
+    frame.insert(frame.end(), hash.begin(), hash.end());
+    Serializable::SetNumber<uint64_t>(frame, TYPE_LEN + HASH_LEN, NowInMs(),
+                                      TIME_LEN);
+    frame.insert(frame.end(), message.begin(), message.end());
+
+    SharedBuffer shared = make_shared<const vector<unsigned char>>(move(frame));
+
+    {
+        lock_guard<mutex> g(m_mutexRumors);
+
+        // The first round goes out right away below
+        if (!StoreRumor(hash,
+                        Rumor{shared, peers, GOSSIP_ROUNDS - 1, Clock::now()}))
+        {
+            LOG_GENERAL(INFO, "Rumor is already being spread.");
+            return;
+        }
+
+        m_recentPeers = peers;
+    }
+
+    Send(PickPeers(peers, GOSSIP_FANOUT), shared);
+}
+
+bool Gossip::ProcessMessage(vector<unsigned char>&& frame, const Peer& from,
+                            const BroadcastListFunc& broadcast_list_retriever,
+                            vector<unsigned char>& message)
+{
+    if (frame.empty())
+    {
+        LOG_GENERAL(WARNING, "Empty gossip message.");
+        return false;
+    }
+
+    switch (frame.front())
+    {
+    case PUSH:
+        return ProcessPush(move(frame), from, broadcast_list_retriever,
+                           message);
+    case DIGEST:
+        ProcessDigest(frame, from);
+        return false;
+    case PULL:
+        ProcessPull(frame, from);
+        return false;
+    default:
+        LOG_GENERAL(WARNING,
+                    "Unknown gossip type " << (unsigned int)frame.front());
+        return false;
+    }
+}
+
+bool Gossip::ProcessPush(vector<unsigned char>&& frame, const Peer& from,
+                         const BroadcastListFunc& broadcast_list_retriever,
+                         vector<unsigned char>& message)
+{
+    if (frame.size() <= PUSH_HDR_LEN)
+    {
+        LOG_GENERAL(WARNING, "Gossip push too short (" << frame.size() << ")");
+        return false;
+    }
+
+    const vector<unsigned char> hash(frame.begin() + TYPE_LEN,
+                                     frame.begin() + TYPE_LEN + HASH_LEN);
+
+    {
+        lock_guard<mutex> g(m_mutexRumors);
+        if (m_rumors.find(hash) != m_rumors.end())
+        {
+            return false;
+        }
+    }
+
+    SHA2<HASH_TYPE::HASH_VARIANT_256> sha256;
+    sha256.Update(frame, PUSH_HDR_LEN, frame.size() - PUSH_HDR_LEN);
+    if (sha256.Finalize() != hash)
+    {
+        LOG_GENERAL(WARNING, "Incorrect gossip message hash.");
+        return false;
+    }
+
+    const uint64_t originTime
+        = Serializable::GetNumber<uint64_t>(frame, TYPE_LEN + HASH_LEN, TIME_LEN);
+    message.assign(frame.begin() + PUSH_HDR_LEN, frame.end());
+
+    vector<Peer> peers;
+    if (broadcast_list_retriever && message.size() > MessageOffset::INST)
+    {
+        peers = broadcast_list_retriever(message.at(MessageOffset::TYPE),
+                                         message.at(MessageOffset::INST), from);
+    }
+
+    SharedBuffer shared = make_shared<const vector<unsigned char>>(move(frame));
+
+    {
+        lock_guard<mutex> g(m_mutexRumors);
+
+        // Lost the race against another copy of the same rumor
+        if (!StoreRumor(hash,
+                        Rumor{shared, peers, GOSSIP_ROUNDS - 1, Clock::now()}))
+        {
+            return false;
+        }
+
+        if (!peers.empty())
+        {
+            m_recentPeers = peers;
+        }
+    }
+
+    m_gossipDelivered++;
+
+    const uint64_t now = NowInMs();
+    if (originTime <= now)
+    {
+        lock_guard<mutex> g(m_mutexStats);
+        m_latencySamples.emplace_back(now - originTime);
+        if (m_latencySamples.size() > MAX_LATENCY_SAMPLES)
+        {
+            m_latencySamples.pop_front();
+        }
+    }
+
+    Send(PickPeers(peers, GOSSIP_FANOUT), shared);
+    return true;
+}
+
+void Gossip::ProcessDigest(const vector<unsigned char>& frame, const Peer& from)
+{
+    if (frame.size() < TYPE_LEN + PORT_LEN
+        || (frame.size() - TYPE_LEN - PORT_LEN) % HASH_LEN != 0)
+    {
+        LOG_GENERAL(WARNING, "Malformed gossip digest (" << frame.size() << ")");
+        return;
+    }
+
+    vector<vector<unsigned char>> missing;
+    {
+        lock_guard<mutex> g(m_mutexRumors);
+
+        for (unsigned int i = TYPE_LEN + PORT_LEN; i < frame.size();
+             i += HASH_LEN)
+        {
+            vector<unsigned char> hash(frame.begin() + i,
+                                       frame.begin() + i + HASH_LEN);
+            if (m_rumors.find(hash) == m_rumors.end())
+            {
+                missing.emplace_back(move(hash));
+            }
+        }
+    }
+
+    if (missing.empty())
+    {
+        return;
+    }
+
+    // Reply to the listen port announced in the digest, not the source port
+    Peer sender(from.m_ipAddress,
+                Serializable::GetNumber<uint32_t>(frame, TYPE_LEN, PORT_LEN));
+    LOG_GENERAL(INFO,
+                "Pulling " << missing.size() << " missed rumors from "
+                           << sender);
+    Send({sender},
+         make_shared<const vector<unsigned char>>(MakeHashList(PULL, missing)));
+}
+
+void Gossip::ProcessPull(const vector<unsigned char>& frame, const Peer& from)
+{
+    if (frame.size() < TYPE_LEN + PORT_LEN
+        || (frame.size() - TYPE_LEN - PORT_LEN) % HASH_LEN != 0)
+    {
+        LOG_GENERAL(WARNING, "Malformed gossip pull (" << frame.size() << ")");
+        return;
+    }
+
+    Peer requester(from.m_ipAddress,
+                   Serializable::GetNumber<uint32_t>(frame, TYPE_LEN, PORT_LEN));
+
+    vector<SharedBuffer> frames;
+    {
+        lock_guard<mutex> g(m_mutexRumors);
+
+        for (unsigned int i = TYPE_LEN + PORT_LEN; i < frame.size();
+             i += HASH_LEN)
+        {
+            auto it = m_rumors.find(vector<unsigned char>(
+                frame.begin() + i, frame.begin() + i + HASH_LEN));
+            if (it != m_rumors.end() && it->second.m_frame)
+            {
+                frames.emplace_back(it->second.m_frame);
+            }
+        }
+    }
+
+    for (const auto& pushFrame : frames)
+    {
+        Send({requester}, pushFrame);
+    }
+}
+
+void Gossip::RunRound()
+{
+    vector<pair<vector<Peer>, SharedBuffer>> pushes;
+    vector<vector<unsigned char>> digest;
+    vector<Peer> antiEntropyPeer;
+
+    {
+        lock_guard<mutex> g(m_mutexRumors);
+
+        const Clock::time_point now = Clock::now();
+        const Clock::duration retention
+            = chrono::milliseconds(GOSSIP_ROUND_INTERVAL_IN_MS) * GOSSIP_ROUNDS
+            * 2;
+
+        for (auto& entry : m_rumors)
+        {
+            Rumor& rumor = entry.second;
+            const Clock::duration age = now - rumor.m_received;
+
+            if (rumor.m_roundsLeft > 0)
+            {
+                pushes.emplace_back(PickPeers(rumor.m_peers, GOSSIP_FANOUT),
+                                    rumor.m_frame);
+                rumor.m_roundsLeft--;
+            }
+            else if (rumor.m_frame && age > retention)
+            {
+                // Pushing is over and anti-entropy had its chance, drop the payload
+                rumor.m_frame.reset();
+            }
+
+            if (rumor.m_frame)
+            {
+                digest.emplace_back(entry.first);
+            }
+        }
+
+        antiEntropyPeer = PickPeers(m_recentPeers, 1);
+    }
+
+    for (const auto& push : pushes)
+    {
+        Send(push.first, push.second);
+    }
+
+    if (!digest.empty())
+    {
+        Send(antiEntropyPeer,
+             make_shared<const vector<unsigned char>>(
+                 MakeHashList(DIGEST, digest)));
+    }
+}
+
+void Gossip::LogStats()
+{
+    vector<uint64_t> samples;
+    {
+        lock_guard<mutex> g(m_mutexStats);
+        samples.assign(m_latencySamples.begin(), m_latencySamples.end());
+    }
+    sort(samples.begin(), samples.end());
+
+    const uint64_t gossipDelivered = m_gossipDelivered;
+    const uint64_t floodDelivered = m_floodDelivered;
+
+    LOG_GENERAL(
+        INFO,
+        "Gossip: delivered = "
+            << gossipDelivered << " bytes/delivered = "
+            << (gossipDelivered ? m_gossipBytes / gossipDelivered : 0)
+            << " p50 = "
+            << (samples.empty() ? 0 : samples.at(samples.size() / 2))
+            << " ms p99 = "
+            << (samples.empty() ? 0 : samples.at(samples.size() * 99 / 100))
+            << " ms | Flooding: delivered = " << floodDelivered
+            << " bytes/delivered = "
+            << (floodDelivered ? m_floodBytes / floodDelivered : 0));
+}
+
+void Gossip::SetSender(const SendFunc& sender) { m_sender = sender; }
+
+void Gossip::RecordFloodSent(uint64_t bytes) { m_floodBytes += bytes; }
+
+void Gossip::RecordFloodDelivered() { m_floodDelivered++; }
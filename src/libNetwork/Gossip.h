@@ -0,0 +1,140 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#ifndef __GOSSIP_H__
+#define __GOSSIP_H__
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Peer.h"
+
+/// Epidemic (push + pull) dissemination for broadcast messages that opt out of flooding.
+class Gossip
+{
+public:
+    enum Type : unsigned char
+    {
+        PUSH = 0x00,
+        DIGEST = 0x01,
+        PULL = 0x02
+    };
+
+    using BroadcastListFunc = std::function<std::vector<Peer>(
+        unsigned char msg_type, unsigned char ins_type, const Peer&)>;
+
+    using SharedBuffer = std::shared_ptr<const std::vector<unsigned char>>;
+
+    using SendFunc = std::function<void(const std::vector<Peer>& peers,
+                                        const SharedBuffer& frame)>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Rumor
+    {
+        /// Complete PUSH frame body, forwarded as is in every round.
+        SharedBuffer m_frame;
+        std::vector<Peer> m_peers;
+        unsigned int m_roundsLeft;
+        Clock::time_point m_received;
+    };
+
+    // Gossip frame layout (after the P2PComm header):
+    // PUSH:   <type> <32-byte hash> <8-byte origin time in ms> <message>
+    // DIGEST: <type> <4-byte listen port> <32-byte hash> ...
+    // PULL:   <type> <4-byte listen port> <32-byte hash> ...
+    static const unsigned int TYPE_LEN = 1;
+    static const unsigned int HASH_LEN = 32;
+    static const unsigned int TIME_LEN = 8;
+    static const unsigned int PORT_LEN = 4;
+    static const unsigned int PUSH_HDR_LEN = TYPE_LEN + HASH_LEN + TIME_LEN;
+    static const unsigned int MAX_LATENCY_SAMPLES = 1024;
+    static const unsigned int STATS_ROUNDS = 300;
+
+    std::mutex m_mutexRumors;
+    std::map<std::vector<unsigned char>, Rumor> m_rumors;
+    // Hashes in the order their rumors were stored, oldest first
+    std::deque<std::pair<Clock::time_point, std::vector<unsigned char>>>
+        m_arrivals;
+    std::vector<Peer> m_recentPeers;
+
+    std::mutex m_mutexStats;
+    std::deque<uint64_t> m_latencySamples;
+    std::atomic<uint64_t> m_gossipBytes{0};
+    std::atomic<uint64_t> m_gossipDelivered{0};
+    std::atomic<uint64_t> m_floodBytes{0};
+    std::atomic<uint64_t> m_floodDelivered{0};
+
+    SendFunc m_sender;
+
+    Gossip();
+    ~Gossip();
+
+    // Singleton should not implement these
+    Gossip(Gossip const&) = delete;
+    void operator=(Gossip const&) = delete;
+
+    static uint64_t NowInMs();
+    static std::vector<Peer> PickPeers(const std::vector<Peer>& peers,
+                                       unsigned int count);
+    std::vector<unsigned char>
+    MakeHashList(Type type, const std::vector<std::vector<unsigned char>>& hashes);
+    void Send(const std::vector<Peer>& peers, const SharedBuffer& frame);
+    bool StoreRumor(const std::vector<unsigned char>& hash, Rumor&& rumor);
+    void LogStats();
+
+    bool ProcessPush(std::vector<unsigned char>&& frame, const Peer& from,
+                     const BroadcastListFunc& broadcast_list_retriever,
+                     std::vector<unsigned char>& message);
+    void ProcessDigest(const std::vector<unsigned char>& frame,
+                       const Peer& from);
+    void ProcessPull(const std::vector<unsigned char>& frame,
+                     const Peer& from);
+
+public:
+    /// Returns the singleton Gossip instance.
+    static Gossip& GetInstance();
+
+    /// Starts spreading a message originated by this node to the specified peers.
+    void SpreadRumor(const std::vector<Peer>& peers,
+                     const std::vector<unsigned char>& message);
+
+    /// Processes an incoming gossip frame; returns true with the message to dispatch if it is new.
+    bool ProcessMessage(std::vector<unsigned char>&& frame, const Peer& from,
+                        const BroadcastListFunc& broadcast_list_retriever,
+                        std::vector<unsigned char>& message);
+
+    /// Pushes the live rumors and sends a digest for anti-entropy. Called every round while gossip is enabled.
+    void RunRound();
+
+    /// Replaces the way frames go out (through P2PComm by default) before any gossip starts, e.g. to capture them in tests.
+    void SetSender(const SendFunc& sender);
+
+    /// Accounts a flooded broadcast so that it can be compared with gossip.
+    void RecordFloodSent(uint64_t bytes);
+
+    /// Accounts a first-time delivery of a flooded broadcast.
+    void RecordFloodDelivered();
+};
+
+#endif // __GOSSIP_H__
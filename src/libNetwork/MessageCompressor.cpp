@@ -0,0 +1,182 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <algorithm>
+#include <iomanip>
+
+#include "MessageCompressor.h"
+#include "common/Messages.h"
+#include "depends/minilzo/minilzo.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+const unsigned int LENGTH_PREFIX = 4;
+
+// An LZO1X match grows by at most 255 bytes per byte of its encoding
+const unsigned int LZO_MAX_EXPANSION = 255;
+const unsigned int LZO_MAX_EXPANSION_SLACK = 64;
+const unsigned int STATS_LOG_SECONDS = 300;
+
+MessageCompressor::MessageCompressor()
+    : m_lastLog(chrono::steady_clock::now())
+{
+    if (lzo_init() != LZO_E_OK)
+    {
+        LOG_GENERAL(FATAL, "LZO initialization failed.");
+    }
+}
+
+MessageCompressor::~MessageCompressor() {}
+
+MessageCompressor& MessageCompressor::GetInstance()
+{
+    static MessageCompressor compressor;
+    return compressor;
+}
+
+bool MessageCompressor::Compress(const vector<unsigned char>& in,
+                                 vector<unsigned char>& out)
+{
+    // LZO needs a dictionary per concurrent compression, keep one per sending thread
+    thread_local vector<unsigned char> workMem(LZO1X_1_MEM_COMPRESS);
+
+    if (in.empty() || in.size() > UINT32_MAX)
+    {
+        return false;
+    }
+
+    // Worst case expansion for incompressible input, as documented by LZO
+    out.resize(LENGTH_PREFIX + in.size() + in.size() / 16 + 64 + 3);
+    out[0] = (unsigned char)((in.size() >> 24) & 0xFF);
+    out[1] = (unsigned char)((in.size() >> 16) & 0xFF);
+    out[2] = (unsigned char)((in.size() >> 8) & 0xFF);
+    out[3] = (unsigned char)(in.size() & 0xFF);
+
+    lzo_uint outLen = 0;
+    if (lzo1x_1_compress(in.data(), in.size(), out.data() + LENGTH_PREFIX,
+                         &outLen, workMem.data())
+        != LZO_E_OK)
+    {
+        LOG_GENERAL(WARNING, "LZO compression failed.");
+        return false;
+    }
+
+    if (LENGTH_PREFIX + outLen >= in.size())
+    {
+        return false;
+    }
+
+    out.resize(LENGTH_PREFIX + outLen);
+    return true;
+}
+
+bool MessageCompressor::Decompress(const unsigned char* in, size_t in_len,
+                                   vector<unsigned char>& out, size_t max_size)
+{
+    if (in_len <= LENGTH_PREFIX)
+    {
+        LOG_GENERAL(WARNING, "Compressed payload too short.");
+        return false;
+    }
+
+    const uint32_t rawLen
+        = (in[0] << 24) + (in[1] << 16) + (in[2] << 8) + in[3];
+
+    // The claimed length is allocated before decoding, so it must be one
+    // this much LZO data can actually expand to
+    const uint64_t maxExpansion
+        = (uint64_t)(in_len - LENGTH_PREFIX) * LZO_MAX_EXPANSION
+        + LZO_MAX_EXPANSION_SLACK;
+    if (rawLen == 0 || rawLen > max_size || rawLen > maxExpansion)
+    {
+        LOG_GENERAL(WARNING,
+                    "Invalid decompressed length "
+                        << rawLen << " for " << in_len << " bytes (max "
+                        << min<uint64_t>(max_size, maxExpansion) << ").");
+        return false;
+    }
+
+    out.resize(rawLen);
+    lzo_uint outLen = rawLen;
+    if (lzo1x_decompress_safe(in + LENGTH_PREFIX, in_len - LENGTH_PREFIX,
+                              out.data(), &outLen, NULL)
+            != LZO_E_OK
+        || outLen != rawLen)
+    {
+        LOG_GENERAL(WARNING, "LZO decompression failed.");
+        return false;
+    }
+
+    return true;
+}
+
+bool MessageCompressor::CompressMessage(const vector<unsigned char>& message,
+                                        size_t threshold,
+                                        vector<unsigned char>& out)
+{
+    if (message.size() < threshold)
+    {
+        return false;
+    }
+
+    bool compressed = Compress(message, out);
+    Record(message, compressed ? out.size() : message.size());
+    return compressed;
+}
+
+void MessageCompressor::Record(const vector<unsigned char>& message,
+                               size_t wire_size)
+{
+    unsigned char msg_type = 0xFF;
+    unsigned char ins_type = 0xFF;
+    if (message.size() > MessageOffset::INST)
+    {
+        msg_type = message.at(MessageOffset::TYPE);
+        ins_type = message.at(MessageOffset::INST);
+    }
+
+    lock_guard<mutex> g(m_mutexStats);
+
+    Ratio& ratio = m_stats[make_pair(msg_type, ins_type)];
+    ratio.m_count++;
+    ratio.m_rawBytes += message.size();
+    ratio.m_wireBytes += wire_size;
+
+    if (chrono::steady_clock::now() - m_lastLog
+        >= chrono::seconds(STATS_LOG_SECONDS))
+    {
+        LogStats();
+        m_lastLog = chrono::steady_clock::now();
+    }
+}
+
+void MessageCompressor::LogStats()
+{
+    for (const auto& entry : m_stats)
+    {
+        const Ratio& ratio = entry.second;
+        LOG_GENERAL(INFO,
+                    "[COMPR] type " << (unsigned int)entry.first.first
+                                    << " ins " << (unsigned int)entry.first.second
+                                    << " msgs " << ratio.m_count << " raw "
+                                    << ratio.m_rawBytes << " wire "
+                                    << ratio.m_wireBytes << " ratio "
+                                    << fixed << setprecision(3)
+                                    << (double)ratio.m_wireBytes
+                                        / ratio.m_rawBytes);
+    }
+}
@@ -0,0 +1,67 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#ifndef __MESSAGECOMPRESSOR_H__
+#define __MESSAGECOMPRESSOR_H__
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/// LZO compression of message payloads on the wire, with per-instruction ratio statistics.
+class MessageCompressor
+{
+    struct Ratio
+    {
+        uint64_t m_count;
+        uint64_t m_rawBytes;
+        uint64_t m_wireBytes;
+    };
+
+    std::mutex m_mutexStats;
+    std::map<std::pair<unsigned char, unsigned char>, Ratio> m_stats;
+    std::chrono::steady_clock::time_point m_lastLog;
+
+    MessageCompressor();
+    ~MessageCompressor();
+
+    // Singleton should not implement these
+    MessageCompressor(MessageCompressor const&) = delete;
+    void operator=(MessageCompressor const&) = delete;
+
+    void Record(const std::vector<unsigned char>& message, size_t wire_size);
+    void LogStats();
+
+public:
+    /// Returns the singleton MessageCompressor instance.
+    static MessageCompressor& GetInstance();
+
+    /// Compresses into out as [4-byte original length][LZO1X-1 data], or returns false if that would not be smaller.
+    static bool Compress(const std::vector<unsigned char>& in,
+                         std::vector<unsigned char>& out);
+
+    /// Restores a payload produced by Compress, refusing anything that expands past max_size or past what LZO can expand in_len bytes to.
+    static bool Decompress(const unsigned char* in, size_t in_len,
+                           std::vector<unsigned char>& out, size_t max_size);
+
+    /// Compresses the message if it is at least threshold bytes and compression pays off, recording the ratio.
+    bool CompressMessage(const std::vector<unsigned char>& message,
+                         size_t threshold, std::vector<unsigned char>& out);
+};
+
+#endif // __MESSAGECOMPRESSOR_H__
@@ -14,6 +14,7 @@
 * and which include a reference to GPLv3 in their program files.
 **/
 
+#include <atomic>
 #include <cstring>
 #include <errno.h>
 #include <event2/buffer.h>
@@ -22,14 +23,19 @@
 #include <event2/event.h>
 #include <event2/listener.h>
 #include <event2/util.h>
+#include <map>
 #include <memory>
 #include <netinet/in.h>
 #include <signal.h>
 #include <stdint.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "Blacklist.h"
+#include "ConnectionPool.h"
+#include "Gossip.h"
+#include "MessageCompressor.h"
 #include "P2PComm.h"
 #include "PeerStore.h"
 #include "common/Messages.h"
@@ -38,17 +44,30 @@
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/JoinableFunction.h"
 #include "libUtils/Logger.h"
+#include "libUtils/Scheduler.h"
 
 using namespace std;
 using namespace boost::multiprecision;
 
 const unsigned char START_BYTE_NORMAL = 0x11;
 const unsigned char START_BYTE_BROADCAST = 0x22;
+const unsigned char START_BYTE_GOSSIP = 0x44;
+const unsigned char START_BYTE_COMPRESSED = 0x80;
 const unsigned int HDR_LEN = 6;
 const unsigned int HASH_LEN = 32;
 
+// How often a reactor checks whether its paused connections may read again
+const unsigned int RESUME_CHECK_MILLISECONDS = 10;
+
+// Jobs taken from each class per scheduling turn
+const unsigned int SEND_WEIGHT_CONSENSUS = 8;
+const unsigned int SEND_WEIGHT_BLOCK = 4;
+const unsigned int SEND_WEIGHT_TRANSACTION = 1;
+const unsigned int SEND_WEIGHT_SYNC = 2;
+
 P2PComm::Dispatcher P2PComm::m_dispatcher;
 P2PComm::BroadcastListFunc P2PComm::m_broadcast_list_retriever;
+P2PComm::ReadyFunc P2PComm::m_ready_checker;
 
 /// Comparison operator for ordering the list of message hashes.
 struct hash_compare
@@ -60,6 +79,30 @@ struct hash_compare
     }
 };
 
+/// Returns the start byte with the compression flag cleared.
+static unsigned char FrameType(unsigned char start_byte)
+{
+    return start_byte & ~START_BYTE_COMPRESSED;
+}
+
+/// Wraps the message for sending, compressing it (and flagging the start byte) when enabled and worthwhile.
+static SharedBuffer PackMessage(const vector<unsigned char>& message,
+                                unsigned char& start_byte)
+{
+    if (WIRE_COMPRESSION)
+    {
+        vector<unsigned char> compressed;
+        if (MessageCompressor::GetInstance().CompressMessage(
+                message, COMPRESSION_THRESHOLD_IN_BYTES, compressed))
+        {
+            start_byte |= START_BYTE_COMPRESSED;
+            return make_shared<const vector<unsigned char>>(move(compressed));
+        }
+    }
+
+    return make_shared<const vector<unsigned char>>(message);
+}
+
 static void close_socket(int* cli_sock)
 {
     if (cli_sock != NULL)
@@ -69,59 +112,23 @@ static void close_socket(int* cli_sock)
     }
 }
 
-static bool comparePairSecond(
-    const pair<vector<unsigned char>, chrono::time_point<chrono::system_clock>>&
-        a,
-    const pair<vector<unsigned char>, chrono::time_point<chrono::system_clock>>&
-        b)
-{
-    return a.second < b.second;
-}
-
 P2PComm::P2PComm()
-    : m_sendQueue(SENDQUEUE_SIZE)
+    : m_broadcastHashes(
+          chrono::seconds(max(BROADCAST_INTERVAL, 1u)),
+          BROADCAST_EXPIRY / max(BROADCAST_INTERVAL, 1u) + 2,
+          BROADCAST_DEDUP_BLOOM_FILTER)
+    , m_sendQueue({SEND_WEIGHT_CONSENSUS, SEND_WEIGHT_BLOCK,
+                   SEND_WEIGHT_TRANSACTION, SEND_WEIGHT_SYNC},
+                  {SENDQUEUE_SIZE_CONSENSUS, SENDQUEUE_SIZE_BLOCK,
+                   SENDQUEUE_SIZE_TRANSACTION, SENDQUEUE_SIZE_SYNC})
+    , m_sendJobsInFlight(0)
 {
-    auto func = [this]() -> void {
-        std::vector<unsigned char> emptyHash;
-
-        while (true)
-        {
-            this_thread::sleep_for(chrono::seconds(BROADCAST_INTERVAL));
-            lock(m_broadcastToRemoveMutex, m_broadcastHashesMutex);
-            lock_guard<mutex> g(m_broadcastToRemoveMutex, adopt_lock);
-            lock_guard<mutex> g2(m_broadcastHashesMutex, adopt_lock);
-
-            if (m_broadcastToRemove.empty()
-                || m_broadcastToRemove.front().second
-                    > chrono::system_clock::now()
-                        - chrono::seconds(BROADCAST_EXPIRY))
-            {
-                continue;
-            }
-
-            auto up = upper_bound(
-                m_broadcastToRemove.begin(), m_broadcastToRemove.end(),
-                make_pair(emptyHash,
-                          chrono::system_clock::now()
-                              - chrono::seconds(BROADCAST_EXPIRY)),
-                comparePairSecond);
-
-            for (auto it = m_broadcastToRemove.begin(); it != up; ++it)
-            {
-                m_broadcastHashes.erase(it->first);
-            }
-
-            m_broadcastToRemove.erase(m_broadcastToRemove.begin(), up);
-        }
-    };
-
-    DetachedFunction(1, func);
 }
 
 P2PComm::~P2PComm()
 {
     SendJob* job = NULL;
-    while (m_sendQueue.pop(job))
+    while (m_sendQueue.TryPop(job))
     {
         delete job;
     }
@@ -133,35 +140,55 @@ P2PComm& P2PComm::GetInstance()
     return comm;
 }
 
-uint32_t SendJob::writeMsg(const void* buf, int cli_sock, const Peer& from,
-                           const uint32_t message_length)
+bool SendJob::writeMsg(struct iovec* iov, int iovcnt, int cli_sock,
+                       const Peer& from)
 {
-    uint32_t written_length = 0;
+    size_t written_length = 0;
 
-    while (written_length < message_length)
-    {
-        ssize_t n = write(cli_sock, (unsigned char*)buf + written_length,
-                          message_length - written_length);
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(struct msghdr));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
 
-        if (errno == EPIPE)
-        {
-            LOG_GENERAL(WARNING,
-                        " SIGPIPE detected. Error No: "
-                            << errno << " Desc: " << std::strerror(errno));
-            return written_length;
-            // No retry as it is likely the other end terminate the conn due to duplicated msg.
-        }
+    while (msg.msg_iovlen > 0)
+    {
+        ssize_t n = sendmsg(cli_sock, &msg, MSG_NOSIGNAL);
 
         if (n <= 0)
         {
+            if (errno == EPIPE)
+            {
+                LOG_GENERAL(WARNING,
+                            " SIGPIPE detected. Error No: "
+                                << errno << " Desc: " << std::strerror(errno));
+                return false;
+                // No retry as it is likely the other end terminate the conn due to duplicated msg.
+            }
+
             LOG_GENERAL(WARNING,
-                        "Socket write failed in message header. Code = "
+                        "Socket write failed. Code = "
                             << errno << " Desc: " << std::strerror(errno)
                             << ". IP address:" << from);
-            return written_length;
+            return false;
         }
 
         written_length += n;
+
+        // Skip the fully written parts and advance into the partially written one
+        size_t remaining = n;
+        while (msg.msg_iovlen > 0 && remaining >= msg.msg_iov->iov_len)
+        {
+            remaining -= msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+
+        if (msg.msg_iovlen > 0)
+        {
+            msg.msg_iov->iov_base = (unsigned char*)msg.msg_iov->iov_base
+                + remaining;
+            msg.msg_iov->iov_len -= remaining;
+        }
     }
 
     if (written_length > 1000000)
@@ -170,13 +197,14 @@ uint32_t SendJob::writeMsg(const void* buf, int cli_sock, const Peer& from,
                     "DEBUG: Sent a total of " << written_length << " bytes");
     }
 
-    return written_length;
+    return true;
 }
 
 bool SendJob::SendMessageSocketCore(const Peer& peer,
                                     const std::vector<unsigned char>& message,
                                     unsigned char start_byte,
-                                    const vector<unsigned char>& msg_hash)
+                                    const vector<unsigned char>& msg_hash,
+                                    bool persistent)
 {
     // LOG_MARKER();
     LOG_PAYLOAD(INFO, "Sending message to " << peer, message,
@@ -196,89 +224,90 @@ bool SendJob::SendMessageSocketCore(const Peer& peer,
         return true;
     }
 
-    try
-    {
-        int cli_sock = socket(AF_INET, SOCK_STREAM, 0);
-        unique_ptr<int, void (*)(int*)> cli_sock_closer(&cli_sock,
-                                                        close_socket);
+    // Transmission format:
+    // 0x01 ~ 0xFF - version, defined in constant file
+    // 0x11 - start byte
+    // 0xLL 0xLL 0xLL 0xLL - 4-byte length of message
+    // <message>
 
-        // LINUX HAS NO SO_NOSIGPIPE
-        //int set = 1;
-        //setsockopt(cli_sock, SOL_SOCKET, SO_NOSIGPIPE, (void *)&set, sizeof(int));
-        signal(SIGPIPE, SIG_IGN);
-        if (cli_sock < 0)
-        {
-            LOG_GENERAL(WARNING,
-                        "Socket creation failed. Code = "
-                            << errno << " Desc: " << std::strerror(errno)
-                            << ". IP address: " << peer);
-            return false;
-        }
+    // 0x01 ~ 0xFF - version, defined in constant file
+    // 0x22 - start byte (broadcast)
+    // 0xLL 0xLL 0xLL 0xLL - 4-byte length of hash + message
+    // <32-byte hash> <message>
 
-        struct sockaddr_in serv_addr;
-        serv_addr.sin_family = AF_INET;
-        serv_addr.sin_addr.s_addr
-            = peer.m_ipAddress.convert_to<unsigned long>();
-        serv_addr.sin_port = htons(peer.m_listenPortHost);
+    // 0x01 ~ 0xFF - version, defined in constant file
+    // 0x33 - start byte (report)
+    // 0x00 0x00 0x00 0x01 - 4-byte length of message
+    // 0x00
 
-        if (connect(cli_sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr))
-            < 0)
-        {
-            LOG_GENERAL(WARNING,
-                        "Socket connect failed. Code = "
-                            << errno << " Desc: " << std::strerror(errno)
-                            << ". IP address: " << peer);
-            return false;
-        }
+    // Start bytes with 0x80 set carry a compressed <message>:
+    // 0xLL 0xLL 0xLL 0xLL - 4-byte length of the original message
+    // <LZO1X-1 data>
+    // The broadcast hash is always that of the original message
+    uint32_t length = message.size();
 
-        // Transmission format:
-        // 0x01 ~ 0xFF - version, defined in constant file
-        // 0x11 - start byte
-        // 0xLL 0xLL 0xLL 0xLL - 4-byte length of message
-        // <message>
+    if (FrameType(start_byte) == START_BYTE_BROADCAST)
+    {
+        length += HASH_LEN;
+    }
 
-        // 0x01 ~ 0xFF - version, defined in constant file
-        // 0x22 - start byte (broadcast)
-        // 0xLL 0xLL 0xLL 0xLL - 4-byte length of hash + message
-        // <32-byte hash> <message>
+    unsigned char buf[HDR_LEN] = {(unsigned char)(MSG_VERSION & 0xFF),
+                                  start_byte,
+                                  (unsigned char)((length >> 24) & 0xFF),
+                                  (unsigned char)((length >> 16) & 0xFF),
+                                  (unsigned char)((length >> 8) & 0xFF),
+                                  (unsigned char)(length & 0xFF)};
 
-        // 0x01 ~ 0xFF - version, defined in constant file
-        // 0x33 - start byte (report)
-        // 0x00 0x00 0x00 0x01 - 4-byte length of message
-        // 0x00
-        uint32_t length = message.size();
+    // Header, hash and body go out in one gathered write, straight from the shared buffers
+    auto writeFrame = [&](int cli_sock) -> bool {
+        struct iovec iov[3];
+        int iovcnt = 0;
 
-        if (start_byte == START_BYTE_BROADCAST)
+        iov[iovcnt].iov_base = buf;
+        iov[iovcnt++].iov_len = HDR_LEN;
+
+        if (FrameType(start_byte) == START_BYTE_BROADCAST)
         {
-            length += HASH_LEN;
+            if (msg_hash.size() != HASH_LEN)
+            {
+                LOG_GENERAL(WARNING, "Wrong message hash length.");
+                return false;
+            }
+
+            iov[iovcnt].iov_base = const_cast<unsigned char*>(msg_hash.data());
+            iov[iovcnt++].iov_len = HASH_LEN;
         }
 
-        unsigned char buf[HDR_LEN] = {(unsigned char)(MSG_VERSION & 0xFF),
-                                      start_byte,
-                                      (unsigned char)((length >> 24) & 0xFF),
-                                      (unsigned char)((length >> 16) & 0xFF),
-                                      (unsigned char)((length >> 8) & 0xFF),
-                                      (unsigned char)(length & 0xFF)};
+        iov[iovcnt].iov_base = const_cast<unsigned char*>(message.data());
+        iov[iovcnt++].iov_len = message.size();
 
-        if (HDR_LEN != writeMsg(buf, cli_sock, peer, HDR_LEN))
-        {
-            LOG_GENERAL(INFO, "DEBUG: not written_length == " << HDR_LEN);
-        }
+        return writeMsg(iov, iovcnt, cli_sock, peer);
+    };
 
-        if (start_byte != START_BYTE_BROADCAST)
+    try
+    {
+        // LINUX HAS NO SO_NOSIGPIPE
+        //int set = 1;
+        //setsockopt(cli_sock, SOL_SOCKET, SO_NOSIGPIPE, (void *)&set, sizeof(int));
+        signal(SIGPIPE, SIG_IGN);
+
+        if (persistent)
         {
-            writeMsg(&message.at(0), cli_sock, peer, length);
-            return true;
+            // A partially written frame corrupts the stream, so the pool
+            // drops that connection and the retry goes out on a fresh one
+            return ConnectionPool::GetInstance().Send(peer, writeFrame);
         }
 
-        if (HASH_LEN != writeMsg(&msg_hash.at(0), cli_sock, peer, HASH_LEN))
+        int cli_sock = ConnectionPool::Connect(peer);
+        if (cli_sock < 0)
         {
-            LOG_GENERAL(WARNING, "Wrong message hash length.");
             return false;
         }
+        unique_ptr<int, void (*)(int*)> cli_sock_closer(&cli_sock,
+                                                        close_socket);
 
-        length -= HASH_LEN;
-        writeMsg(&message.at(0), cli_sock, peer, length);
+        // Once connected, a short write is not retried on a one-shot connection
+        writeFrame(cli_sock);
     }
     catch (const std::exception& e)
     {
@@ -289,12 +318,13 @@ bool SendJob::SendMessageSocketCore(const Peer& peer,
 }
 
 void SendJob::SendMessageCore(const Peer& peer,
-                              const vector<unsigned char> message,
+                              const vector<unsigned char>& message,
                               unsigned char startbyte,
-                              const vector<unsigned char> hash)
+                              const vector<unsigned char>& hash,
+                              bool persistent)
 {
     uint32_t retry_counter = 0;
-    while (!SendMessageSocketCore(peer, message, startbyte, hash))
+    while (!SendMessageSocketCore(peer, message, startbyte, hash, persistent))
     {
         retry_counter++;
         LOG_GENERAL(WARNING,
@@ -314,7 +344,7 @@ void SendJob::SendMessageCore(const Peer& peer,
     }
 }
 
-void SendJobPeer::DoSend()
+void SendJobPeer::DoSend(const function<void()>& done)
 {
     if (Blacklist::GetInstance().Exist(m_peer.m_ipAddress))
     {
@@ -322,36 +352,218 @@ void SendJobPeer::DoSend()
                     "The node "
                         << m_peer
                         << " is in black list, block all message to it.");
+    }
+    else
+    {
+        SendMessageCore(m_peer, *m_message, m_startbyte, m_hash,
+                        PERSISTENT_CONNECTION);
+    }
+
+    done();
+}
+
+/// Message and bookkeeping shared by all rounds of one multicast.
+struct MulticastState
+{
+    Peer m_selfPeer;
+    unsigned char m_startbyte;
+    SharedBuffer m_message;
+    vector<unsigned char> m_hash;
+    PeerSendCallback m_callback;
+    SendClass m_class;
+    function<void()> m_done;
+    chrono::steady_clock::time_point m_startTime;
+    atomic<unsigned int> m_delivered{0};
+    atomic<unsigned int> m_failed{0};
+};
+
+/// One pass over a set of peers, shared by the lanes that send it.
+struct MulticastRound
+{
+    shared_ptr<MulticastState> m_state;
+    vector<Peer> m_peers;
+    unsigned int m_retry;
+    atomic<size_t> m_next{0};
+    atomic<unsigned int> m_lanesLeft{0};
+    mutex m_mutexFailed;
+    vector<Peer> m_failed;
+};
+
+WeightedJobQueue<function<void()>>& SendJob::GetMulticastQueue()
+{
+    // At most MAXMESSAGE jobs are in flight, each with no more than
+    // MULTICAST_PARALLELISM lanes queued, so pushing a lane never blocks.
+    // The queue is never destroyed, its detached senders wait on it until exit
+    const size_t limit = MAXMESSAGE * max(MULTICAST_PARALLELISM, 1u);
+    static auto* queue = new WeightedJobQueue<function<void()>>(
+        {SEND_WEIGHT_CONSENSUS, SEND_WEIGHT_BLOCK, SEND_WEIGHT_TRANSACTION,
+         SEND_WEIGHT_SYNC},
+        {limit, limit, limit, limit});
+
+    // Lanes of all jobs in flight share the senders by class, like the jobs
+    static once_flag started;
+    call_once(started, [] {
+        DetachedFunction(max(MULTICAST_POOL_SIZE, 1u), [] {
+            while (true)
+            {
+                queue->Pop()();
+            }
+        });
+    });
+
+    return *queue;
+}
+
+Scheduler& SendJob::GetRetryScheduler()
+{
+    // Never destroyed: its detached thread may still be waiting on it at exit
+    static Scheduler* scheduler = new Scheduler;
+
+    static once_flag started;
+    call_once(started, [] {
+        DetachedFunction(1, [] { scheduler->ServiceQueue(); });
+    });
+
+    return *scheduler;
+}
+
+void SendJob::StartMulticastRound(const shared_ptr<MulticastState>& state,
+                                  vector<Peer>&& peers, unsigned int retry)
+{
+    if (peers.empty())
+    {
+        FinishMulticast(state);
         return;
     }
 
-    SendMessageCore(m_peer, m_message, m_startbyte, m_hash);
+    auto round = make_shared<MulticastRound>();
+    round->m_state = state;
+    round->m_peers = move(peers);
+    round->m_retry = retry;
+
+    // Every lane pulls the next unsent peer, so a slow peer only holds up its own lane
+    const unsigned int lanes = max(
+        1u,
+        min(MULTICAST_PARALLELISM, (unsigned int)round->m_peers.size()));
+    round->m_lanesLeft = lanes;
+
+    for (unsigned int i = 0; i < lanes; i++)
+    {
+        GetMulticastQueue().Push(
+            state->m_class, [round]() -> void { RunMulticastLane(round); });
+    }
+}
+
+void SendJob::RunMulticastLane(const shared_ptr<MulticastRound>& round)
+{
+    const shared_ptr<MulticastState>& state = round->m_state;
+    size_t index;
+
+    while ((index = round->m_next++) < round->m_peers.size())
+    {
+        const Peer& peer = round->m_peers.at(index);
+
+        // Single attempt only, failed peers are retried after this round
+        if (SendMessageSocketCore(peer, *state->m_message, state->m_startbyte,
+                                  state->m_hash, PERSISTENT_CONNECTION))
+        {
+            state->m_delivered++;
+
+            if (state->m_callback)
+            {
+                state->m_callback(peer, true);
+            }
+        }
+        else
+        {
+            lock_guard<mutex> g(round->m_mutexFailed);
+            round->m_failed.emplace_back(peer);
+        }
+    }
+
+    if (--round->m_lanesLeft == 0)
+    {
+        EndMulticastRound(round);
+    }
 }
 
-template<class T> void SendJobPeers<T>::DoSend()
+void SendJob::EndMulticastRound(const shared_ptr<MulticastRound>& round)
 {
-    vector<unsigned int> indexes(m_peers.size());
+    const shared_ptr<MulticastState>& state = round->m_state;
 
-    for (unsigned int i = 0; i < indexes.size(); i++)
+    if (round->m_failed.empty())
     {
-        indexes.at(i) = i;
+        FinishMulticast(state);
+        return;
     }
-    random_shuffle(indexes.begin(), indexes.end());
 
-    if ((m_startbyte == START_BYTE_BROADCAST) && (m_selfPeer != Peer()))
+    if (round->m_retry >= MAXRETRYCONN)
+    {
+        for (const auto& peer : round->m_failed)
+        {
+            LOG_GENERAL(WARNING,
+                        "Socket connect failed over " << MAXRETRYCONN
+                                                      << " times. IP address: "
+                                                      << peer);
+            state->m_failed++;
+
+            if (state->m_callback)
+            {
+                state->m_callback(peer, false);
+            }
+        }
+
+        FinishMulticast(state);
+        return;
+    }
+
+    LOG_GENERAL(WARNING,
+                "Retrying " << round->m_failed.size() << " peers ("
+                            << round->m_retry + 1 << "/" << MAXRETRYCONN
+                            << ")");
+
+    // Back off on a timer rather than a sender, so no lane waits on the delay
+    vector<Peer> failed = move(round->m_failed);
+    const unsigned int retry = round->m_retry + 1;
+    GetRetryScheduler().ScheduleAfter(
+        [state, failed, retry]() mutable -> void {
+            StartMulticastRound(state, move(failed), retry);
+        },
+        rand() % PUMPMESSAGE_MILLISECONDS);
+}
+
+void SendJob::FinishMulticast(const shared_ptr<MulticastState>& state)
+{
+    if ((FrameType(state->m_startbyte) == START_BYTE_BROADCAST)
+        && (state->m_selfPeer != Peer()))
     {
         LOG_STATE("[BROAD]["
                   << std::setw(15) << std::left
-                  << m_selfPeer.GetPrintableIPAddress() << "]["
-                  << DataConversion::Uint8VecToHexStr(m_hash).substr(0, 6)
-                  << "] BEGN");
+                  << state->m_selfPeer.GetPrintableIPAddress() << "]["
+                  << DataConversion::Uint8VecToHexStr(state->m_hash).substr(0, 6)
+                  << "] DONE");
     }
 
-    for (vector<unsigned int>::const_iterator curr = indexes.begin();
-         curr < indexes.end(); curr++)
-    {
-        const Peer& peer = m_peers.at(*curr);
+    LOG_GENERAL(INFO,
+                "Multicast done, delivered = "
+                    << state->m_delivered << " failed = " << state->m_failed
+                    << " in "
+                    << chrono::duration_cast<chrono::milliseconds>(
+                           chrono::steady_clock::now() - state->m_startTime)
+                           .count()
+                    << " ms");
+
+    state->m_done();
+}
+
+template<class T>
+void SendJobPeers<T>::DoSend(const function<void()>& done)
+{
+    vector<Peer> peers;
+    peers.reserve(m_peers.size());
 
+    for (const auto& peer : m_peers)
+    {
         /// TBD: Update the container dynamically when blacklist is updated
         if (Blacklist::GetInstance().Exist(peer.m_ipAddress))
         {
@@ -362,40 +574,143 @@ template<class T> void SendJobPeers<T>::DoSend()
             continue;
         }
 
-        SendMessageCore(peer, m_message, m_startbyte, m_hash);
+        peers.emplace_back(peer);
     }
+    random_shuffle(peers.begin(), peers.end());
 
-    if ((m_startbyte == START_BYTE_BROADCAST) && (m_selfPeer != Peer()))
+    if ((FrameType(m_startbyte) == START_BYTE_BROADCAST)
+        && (m_selfPeer != Peer()))
     {
         LOG_STATE("[BROAD]["
                   << std::setw(15) << std::left
                   << m_selfPeer.GetPrintableIPAddress() << "]["
                   << DataConversion::Uint8VecToHexStr(m_hash).substr(0, 6)
-                  << "] DONE");
+                  << "] BEGN");
     }
+
+    // The lanes share the job's payload, which outlives the job itself
+    auto state = make_shared<MulticastState>();
+    state->m_selfPeer = m_selfPeer;
+    state->m_startbyte = m_startbyte;
+    state->m_message = m_message;
+    state->m_hash = move(m_hash);
+    state->m_callback = m_callback;
+    state->m_class = m_class;
+    state->m_done = done;
+    state->m_startTime = chrono::steady_clock::now();
+
+    StartMulticastRound(state, move(peers), 0);
 }
 
 void P2PComm::ProcessSendJob(SendJob* job)
 {
-    auto funcSendMsg = [job]() mutable -> void {
-        job->DoSend();
+    {
+        lock_guard<mutex> g(m_mutexSendJobsInFlight);
+        m_sendJobsInFlight++;
+    }
+
+    // A multicast stays in flight until its last lane is done, not just
+    // until its lanes are queued
+    auto funcDone = [this]() -> void {
+        {
+            lock_guard<mutex> g(m_mutexSendJobsInFlight);
+            m_sendJobsInFlight--;
+        }
+        m_cvSendJobsInFlight.notify_one();
+    };
+
+    auto funcSendMsg = [job, funcDone]() mutable -> void {
+        job->DoSend(funcDone);
         delete job;
     };
     m_SendPool.AddJob(funcSendMsg);
 }
 
-void P2PComm::ClearBroadcastHashAsync(const vector<unsigned char>& message_hash)
+void P2PComm::QueueSendJob(SendClass cls, SendJob* job)
 {
-    LOG_MARKER();
-    lock_guard<mutex> guard(m_broadcastToRemoveMutex);
-    m_broadcastToRemove.emplace_back(message_hash, chrono::system_clock::now());
+    job->m_class = cls;
+    m_sendQueue.Push(cls, job);
+}
+
+SendClass P2PComm::ClassifyMessage(const vector<unsigned char>& message)
+{
+    if (message.size() <= MessageOffset::INST)
+    {
+        return SEND_SYNC;
+    }
+
+    const unsigned char ins_type = message.at(MessageOffset::INST);
+
+    switch (message.at(MessageOffset::TYPE))
+    {
+    case MessageType::DIRECTORY:
+        switch (ins_type)
+        {
+        case DSInstructionType::SETPRIMARY:
+        case DSInstructionType::DSBLOCKCONSENSUS:
+        case DSInstructionType::FINALBLOCKCONSENSUS:
+        case DSInstructionType::VIEWCHANGECONSENSUS:
+            return SEND_CONSENSUS;
+        default:
+            return SEND_BLOCK;
+        }
+    case MessageType::NODE:
+        switch (ins_type)
+        {
+        case NodeInstructionType::MICROBLOCKCONSENSUS:
+            return SEND_CONSENSUS;
+        case NodeInstructionType::CREATETRANSACTION:
+        case NodeInstructionType::SUBMITTRANSACTION:
+        case NodeInstructionType::FORWARDTRANSACTION:
+        case NodeInstructionType::CREATETRANSACTIONFROMLOOKUP:
+            return SEND_TRANSACTION;
+        case NodeInstructionType::DOREJOIN:
+            return SEND_SYNC;
+        default:
+            return SEND_BLOCK;
+        }
+    case MessageType::CONSENSUSUSER:
+        return SEND_CONSENSUS;
+    default:
+        return SEND_SYNC;
+    }
 }
 
-void P2PComm::EventCallback(struct bufferevent* bev, short events,
-                            [[gnu::unused]] void* ctx)
+vector<size_t> P2PComm::GetSendQueueDepths() { return m_sendQueue.Depths(); }
+
+struct ConnectionContext;
+
+/// One receive event loop with its own listener on the shared port.
+struct Reactor
+{
+    unsigned int m_id;
+    struct event_base* m_base;
+    struct evconnlistener* m_listener;
+    struct event* m_statsTimer;
+    struct event* m_resumeTimer;
+    // Connections not being read because their last message type is backed up.
+    // Only touched on this reactor's thread
+    map<struct bufferevent*, ConnectionContext*> m_paused;
+    atomic<uint64_t> m_connections{0};
+    atomic<uint64_t> m_messages{0};
+    atomic<uint64_t> m_bytes{0};
+};
+
+/// Receive state of one accepted connection.
+struct ConnectionContext
 {
+    Peer m_from;
+    Reactor* m_reactor;
+    unsigned char m_pausedType;
+};
+
+void P2PComm::EventCallback(struct bufferevent* bev, short events, void* ctx)
+{
+    unique_ptr<ConnectionContext> context(static_cast<ConnectionContext*>(ctx));
+    const Peer& from = context->m_from;
     unique_ptr<struct bufferevent, decltype(&bufferevent_free)> socket_closer(
         bev, bufferevent_free);
+    context->m_reactor->m_paused.erase(bev);
 
     if (events & BEV_EVENT_ERROR)
     {
@@ -403,45 +718,40 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
         return;
     }
 
+    if (events & BEV_EVENT_TIMEOUT)
+    {
+        LOG_GENERAL(INFO, "Closing idle connection from " << from);
+        return;
+    }
+
     // Not all bytes read out
-    if (!(events & (BEV_EVENT_EOF | BEV_EVENT_ERROR)))
+    if (!(events & BEV_EVENT_EOF))
     {
         LOG_GENERAL(WARNING, "Unknown error from bufferevent.");
         return;
     }
 
-    // Get the IP info
-    int fd = bufferevent_getfd(bev);
-    struct sockaddr_in cli_addr;
-    socklen_t addr_size = sizeof(struct sockaddr_in);
-    getpeername(fd, (struct sockaddr*)&cli_addr, &addr_size);
-    Peer from(cli_addr.sin_addr.s_addr, cli_addr.sin_port);
+    struct evbuffer* input = bufferevent_get_input(bev);
+    if (input != NULL && evbuffer_get_length(input) > 0)
+    {
+        LOG_GENERAL(WARNING,
+                    "Connection from " << from << " closed with "
+                                       << evbuffer_get_length(input)
+                                       << " bytes of an incomplete message.");
+    }
+}
+
+void P2PComm::ReadCallback(struct bufferevent* bev, void* ctx)
+{
+    ConnectionContext* context = static_cast<ConnectionContext*>(ctx);
+    const Peer& from = context->m_from;
 
-    // Get the data stored in buffer
     struct evbuffer* input = bufferevent_get_input(bev);
     if (input == NULL)
     {
         LOG_GENERAL(WARNING, "bufferevent_get_input failure.");
         return;
     }
-    size_t len = evbuffer_get_length(input);
-    if (len == 0)
-    {
-        LOG_GENERAL(WARNING, "evbuffer_get_length failure.");
-        return;
-    }
-    vector<unsigned char> message(len);
-    if (evbuffer_copyout(input, message.data(), len)
-        != static_cast<ev_ssize_t>(len))
-    {
-        LOG_GENERAL(WARNING, "evbuffer_copyout failure.");
-        return;
-    }
-    if (evbuffer_drain(input, len) != 0)
-    {
-        LOG_GENERAL(WARNING, "evbuffer_drain failure.");
-        return;
-    }
 
     // Reception format:
     // 0x01 ~ 0xFF - version, defined in constant file
@@ -459,142 +769,300 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
     // 0x00 0x00 0x00 0x01 - 4-byte length of message
     // 0x00
 
-    // Check for minimum message size
-    if (message.size() <= HDR_LEN)
-    {
-        LOG_GENERAL(WARNING, "Empty message received.");
-        return;
-    }
+    // Start bytes with 0x80 set carry a compressed <message>
 
-    const unsigned char version = message[0];
-    const unsigned char startByte = message[1];
-
-    // Check for version requirement
-    if (version != (unsigned char)(MSG_VERSION & 0xFF))
+    // A connection may carry any number of messages back to back
+    while (evbuffer_get_length(input) >= HDR_LEN)
     {
-        LOG_GENERAL(WARNING,
-                    "Header version wrong, received ["
-                        << version - 0x00 << "] while expected [" << MSG_VERSION
-                        << "].");
-        return;
-    }
+        unsigned char header[HDR_LEN];
+        if (evbuffer_copyout(input, header, HDR_LEN)
+            != static_cast<ev_ssize_t>(HDR_LEN))
+        {
+            LOG_GENERAL(WARNING, "evbuffer_copyout failure.");
+            bufferevent_free(bev);
+            delete context;
+            return;
+        }
 
-    const uint32_t messageLength = (message[2] << 24) + (message[3] << 16)
-        + (message[4] << 8) + message[5];
+        const unsigned char version = header[0];
+        const bool compressed = (header[1] & START_BYTE_COMPRESSED) != 0;
+        const unsigned char startByte = FrameType(header[1]);
+        const uint32_t messageLength = (header[2] << 24) + (header[3] << 16)
+            + (header[4] << 8) + header[5];
 
-    // Check for length consistency
-    if (messageLength != message.size() - HDR_LEN)
-    {
-        LOG_GENERAL(WARNING, "Incorrect message length.");
-        return;
-    }
+        // Check the header before buffering anything behind it
+        string error;
+        if (version != (unsigned char)(MSG_VERSION & 0xFF))
+        {
+            LOG_GENERAL(WARNING,
+                        "Header version wrong, received ["
+                            << version - 0x00 << "] while expected ["
+                            << MSG_VERSION << "].");
+            error = "wrong version";
+        }
+        else if (startByte != START_BYTE_NORMAL
+                 && startByte != START_BYTE_BROADCAST
+                 && startByte != START_BYTE_GOSSIP)
+        {
+            // Unexpected start byte. Drop this message
+            LOG_GENERAL(WARNING, "Incorrect start byte.");
+            error = "wrong start byte";
+        }
+        else if (messageLength > MAX_MESSAGE_SIZE)
+        {
+            LOG_GENERAL(WARNING,
+                        "Incorrect message length " << messageLength
+                                                    << " (max "
+                                                    << MAX_MESSAGE_SIZE << ").");
+            error = "wrong length";
+        }
 
-    if (startByte == START_BYTE_BROADCAST)
-    {
-        if ((messageLength - HDR_LEN) <= HASH_LEN)
+        if (!error.empty())
         {
-            LOG_GENERAL(
-                WARNING,
-                "Hash missing or empty broadcast message (messageLength = "
-                    << messageLength << ")");
+            // The stream can't be re-synchronized, so drop the connection
+            LOG_GENERAL(WARNING,
+                        "Closing connection from " << from << ": " << error);
+            bufferevent_free(bev);
+            delete context;
             return;
         }
 
-        vector<unsigned char> msg_hash(message.begin() + HDR_LEN,
-                                       message.begin() + HDR_LEN + HASH_LEN);
+        if (evbuffer_get_length(input) < HDR_LEN + messageLength)
+        {
+            // Don't wake up again until the whole message is in
+            bufferevent_setwatermark(bev, EV_READ, HDR_LEN + messageLength, 0);
+            return;
+        }
+
+        evbuffer_drain(input, HDR_LEN);
+        context->m_reactor->m_messages++;
+        context->m_reactor->m_bytes += HDR_LEN + messageLength;
+
+        if (messageLength == 0)
+        {
+            // An empty message is a whole frame, there is just nothing to hand on
+            continue;
+        }
 
-        P2PComm& p2p = P2PComm::GetInstance();
+        if (compressed && !WIRE_COMPRESSION)
+        {
+            // Compression is agreed on network wide through the option, like MSG_VERSION
+            LOG_GENERAL(WARNING,
+                        "Dropping compressed message from "
+                            << from << ", wire compression is off");
+            evbuffer_drain(input, messageLength);
+            continue;
+        }
 
-        // Check if this message has been received before
-        bool found = false;
+        if (startByte == START_BYTE_GOSSIP && !BROADCAST_GOSSIP_MODE)
         {
-            lock_guard<mutex> guard(p2p.m_broadcastHashesMutex);
+            // Nothing would ever expire or relay it here, so skip it unread
+            LOG_GENERAL(WARNING,
+                        "Dropping gossip message from " << from
+                                                        << ", gossip is off");
+            evbuffer_drain(input, messageLength);
+            continue;
+        }
 
-            found = (p2p.m_broadcastHashes.find(msg_hash)
-                     != p2p.m_broadcastHashes.end());
-            // While we have the lock, we should quickly add the hash
-            if (!found)
+        vector<unsigned char> msg_hash;
+        uint32_t bodyLength = messageLength;
+
+        if (startByte == START_BYTE_BROADCAST)
+        {
+            if (messageLength <= HASH_LEN)
             {
-                SHA2<HASH_TYPE::HASH_VARIANT_256> sha256;
-                sha256.Update(message, HDR_LEN + HASH_LEN,
-                              message.size() - HDR_LEN - HASH_LEN);
-                vector<unsigned char> this_msg_hash = sha256.Finalize();
-
-                if (this_msg_hash == msg_hash)
-                {
-                    p2p.m_broadcastHashes.insert(this_msg_hash);
-                }
-                else
-                {
-                    LOG_GENERAL(WARNING, "Incorrect message hash.");
-                    return;
-                }
+                LOG_GENERAL(
+                    WARNING,
+                    "Hash missing or empty broadcast message (messageLength = "
+                        << messageLength << ")");
+                evbuffer_drain(input, messageLength);
+                continue;
             }
+
+            msg_hash.resize(HASH_LEN);
+            evbuffer_remove(input, msg_hash.data(), HASH_LEN);
+            bodyLength -= HASH_LEN;
         }
 
-        if (found)
+        // Move the body straight out of the socket buffer into its final place
+        vector<unsigned char> message(bodyLength);
+        if (evbuffer_remove(input, message.data(), bodyLength)
+            != static_cast<int>(bodyLength))
         {
-            // We already sent and/or received this message before -> discard
-            LOG_GENERAL(INFO, "Discarding duplicate broadcast message.");
+            LOG_GENERAL(WARNING, "evbuffer_remove failure.");
+            bufferevent_free(bev);
+            delete context;
             return;
         }
 
-        unsigned char msg_type = 0xFF;
-        unsigned char ins_type = 0xFF;
-        if (messageLength - HASH_LEN > MessageOffset::INST)
+        if (compressed)
         {
-            msg_type = message.at(HDR_LEN + HASH_LEN + MessageOffset::TYPE);
-            ins_type = message.at(HDR_LEN + HASH_LEN + MessageOffset::INST);
+            // The frame itself was intact, so only this message is lost
+            vector<unsigned char> decompressed;
+            if (!MessageCompressor::Decompress(message.data(), message.size(),
+                                               decompressed, MAX_MESSAGE_SIZE))
+            {
+                LOG_GENERAL(WARNING,
+                            "Dropping undecodable compressed message from "
+                                << from);
+                continue;
+            }
+            message = move(decompressed);
         }
 
-        vector<Peer> broadcast_list
-            = m_broadcast_list_retriever(msg_type, ins_type, from);
+        bool dispatched = false;
+        unsigned char msgType = (message.size() > MessageOffset::TYPE)
+            ? message.at(MessageOffset::TYPE)
+            : 0xFF;
 
-        if (broadcast_list.size() > 0)
+        if (startByte == START_BYTE_BROADCAST)
+        {
+            dispatched = ProcessBroadcastMessage(message, msg_hash, from);
+        }
+        else if (startByte == START_BYTE_GOSSIP)
+        {
+            vector<unsigned char> rumor;
+            if (Gossip::GetInstance().ProcessMessage(
+                    move(message), from, m_broadcast_list_retriever, rumor))
+            {
+                msgType = (rumor.size() > MessageOffset::TYPE)
+                    ? rumor.at(MessageOffset::TYPE)
+                    : 0xFF;
+                m_dispatcher(
+                    new pair<vector<unsigned char>, Peer>(move(rumor), from));
+                dispatched = true;
+            }
+        }
+        else
         {
-            p2p.RebroadcastMessage(broadcast_list, message, msg_hash);
+            // Queue the message
+            m_dispatcher(
+                new pair<vector<unsigned char>, Peer>(move(message), from));
+            dispatched = true;
         }
 
-        p2p.ClearBroadcastHashAsync(msg_hash);
+        if (dispatched && !IsReady(msgType))
+        {
+            // Leave the rest in the socket until the handlers catch up, so
+            // TCP flow control slows this sender down instead of us dropping
+            Reactor* reactor = context->m_reactor;
+            bufferevent_setwatermark(bev, EV_READ, 0, 0);
+            bufferevent_disable(bev, EV_READ);
+            context->m_pausedType = msgType;
+            reactor->m_paused.emplace(bev, context);
+
+            if (!evtimer_pending(reactor->m_resumeTimer, NULL))
+            {
+                struct timeval interval
+                    = {0, (long)RESUME_CHECK_MILLISECONDS * 1000};
+                evtimer_add(reactor->m_resumeTimer, &interval);
+            }
+            return;
+        }
+    }
 
-        LOG_STATE("[BROAD]["
-                  << std::setw(15) << std::left << p2p.m_selfPeer << "]["
-                  << DataConversion::Uint8VecToHexStr(msg_hash).substr(0, 6)
-                  << "] RECV");
+    bufferevent_setwatermark(bev, EV_READ, 0, 0);
+}
+
+bool P2PComm::IsReady(unsigned char msg_type)
+{
+    return (m_ready_checker == nullptr) || m_ready_checker(msg_type);
+}
 
-        // Move the shared_ptr message to raw pointer type
-        pair<vector<unsigned char>, Peer>* raw_message
-            = new pair<vector<unsigned char>, Peer>(
-                vector<unsigned char>(message.begin() + HDR_LEN + HASH_LEN,
-                                      message.end()),
-                from);
+void P2PComm::ResumeConnections([[gnu::unused]] evutil_socket_t fd,
+                                [[gnu::unused]] short events, void* arg)
+{
+    Reactor* reactor = static_cast<Reactor*>(arg);
 
-        // Queue the message
-        m_dispatcher(raw_message);
+    for (auto it = reactor->m_paused.begin(); it != reactor->m_paused.end();)
+    {
+        if (!IsReady(it->second->m_pausedType))
+        {
+            it++;
+            continue;
+        }
+
+        struct bufferevent* bev = it->first;
+        ConnectionContext* context = it->second;
+        it = reactor->m_paused.erase(it);
+
+        bufferevent_enable(bev, EV_READ);
+
+        // Whole messages may be buffered already, and they raise no new read event
+        ReadCallback(bev, context);
     }
-    else if (startByte == START_BYTE_NORMAL)
+
+    if (!reactor->m_paused.empty())
     {
-        // Move the shared_ptr message to raw pointer type
-        pair<vector<unsigned char>, Peer>* raw_message
-            = new pair<vector<unsigned char>, Peer>(
-                vector<unsigned char>(message.begin() + HDR_LEN, message.end()),
-                from);
+        struct timeval interval = {0, (long)RESUME_CHECK_MILLISECONDS * 1000};
+        evtimer_add(reactor->m_resumeTimer, &interval);
+    }
+}
 
-        // Queue the message
-        m_dispatcher(raw_message);
+bool P2PComm::ProcessBroadcastMessage(vector<unsigned char>& message,
+                                      const vector<unsigned char>& msg_hash,
+                                      const Peer& from)
+{
+    P2PComm& p2p = P2PComm::GetInstance();
+
+    // Cheap lookup first, so duplicates don't cost a SHA-256 each
+    if (p2p.m_broadcastHashes.Contains(msg_hash))
+    {
+        // We already sent and/or received this message before -> discard
+        LOG_GENERAL(INFO, "Discarding duplicate broadcast message.");
+        return false;
     }
-    else
+
+    SHA2<HASH_TYPE::HASH_VARIANT_256> sha256;
+    sha256.Update(message);
+    if (sha256.Finalize() != msg_hash)
+    {
+        LOG_GENERAL(WARNING, "Incorrect message hash.");
+        return false;
+    }
+
+    // Another reactor may have taken the same message in the meantime
+    if (!p2p.m_broadcastHashes.Insert(msg_hash))
+    {
+        LOG_GENERAL(INFO, "Discarding duplicate broadcast message.");
+        return false;
+    }
+
+    if (BROADCAST_GOSSIP_MODE)
+    {
+        Gossip::GetInstance().RecordFloodDelivered();
+    }
+
+    unsigned char msg_type = 0xFF;
+    unsigned char ins_type = 0xFF;
+    if (message.size() > MessageOffset::INST)
+    {
+        msg_type = message.at(MessageOffset::TYPE);
+        ins_type = message.at(MessageOffset::INST);
+    }
+
+    vector<Peer> broadcast_list
+        = m_broadcast_list_retriever(msg_type, ins_type, from);
+
+    if (broadcast_list.size() > 0)
     {
-        // Unexpected start byte. Drop this message
-        LOG_GENERAL(WARNING, "Incorrect start byte.");
+        p2p.RebroadcastMessage(broadcast_list, message, msg_hash);
     }
+
+    LOG_STATE("[BROAD]["
+              << std::setw(15) << std::left << p2p.m_selfPeer << "]["
+              << DataConversion::Uint8VecToHexStr(msg_hash).substr(0, 6)
+              << "] RECV");
+
+    // Queue the message
+    m_dispatcher(new pair<vector<unsigned char>, Peer>(move(message), from));
+    return true;
 }
 
 void P2PComm::AcceptConnectionCallback([[gnu::unused]] evconnlistener* listener,
                                        evutil_socket_t cli_sock,
                                        struct sockaddr* cli_addr,
-                                       [[gnu::unused]] int socklen,
-                                       [[gnu::unused]] void* arg)
+                                       [[gnu::unused]] int socklen, void* arg)
 {
     Peer from(uint128_t(((struct sockaddr_in*)cli_addr)->sin_addr.s_addr),
               ((struct sockaddr_in*)cli_addr)->sin_port);
@@ -638,35 +1106,51 @@ void P2PComm::AcceptConnectionCallback([[gnu::unused]] evconnlistener* listener,
         return;
     }
 
-    bufferevent_setcb(bev, NULL, NULL, EventCallback, NULL);
+    // Senders keep their connections open, reap those that went quiet
+    struct timeval idle_timeout
+        = {(time_t)CONNECTION_IDLE_TIMEOUT_IN_SECONDS * 2, 0};
+    bufferevent_set_timeouts(bev, &idle_timeout, NULL);
+
+    Reactor* reactor = static_cast<Reactor*>(arg);
+    reactor->m_connections++;
+
+    bufferevent_setcb(bev, ReadCallback, NULL, EventCallback,
+                      new ConnectionContext{from, reactor, 0xFF});
     bufferevent_enable(bev, EV_READ | EV_WRITE);
 }
 
-void P2PComm::StartMessagePump(uint32_t listen_port_host, Dispatcher dispatcher,
-                               BroadcastListFunc broadcast_list_retriever)
+void P2PComm::LogReactorStats([[gnu::unused]] evutil_socket_t fd,
+                              [[gnu::unused]] short events, void* arg)
 {
-    LOG_MARKER();
+    const Reactor* reactor = static_cast<Reactor*>(arg);
 
-    // Launch the thread that reads messages from the send queue
-    auto funcCheckSendQueue = [this]() mutable -> void {
-        SendJob* job = NULL;
-        while (true)
-        {
-            while (m_sendQueue.pop(job))
-            {
-                ProcessSendJob(job);
-            }
-        }
-    };
-    DetachedFunction(1, funcCheckSendQueue);
+    LOG_GENERAL(INFO,
+                "Reactor " << reactor->m_id
+                           << ": connections = " << reactor->m_connections
+                           << " messages = " << reactor->m_messages
+                           << " bytes = " << reactor->m_bytes);
 
+    if (reactor->m_id == 0)
+    {
+        vector<size_t> depths = P2PComm::GetInstance().GetSendQueueDepths();
+        LOG_GENERAL(INFO,
+                    "Send queue depth: consensus = "
+                        << depths.at(SEND_CONSENSUS)
+                        << " block = " << depths.at(SEND_BLOCK)
+                        << " transaction = " << depths.at(SEND_TRANSACTION)
+                        << " sync = " << depths.at(SEND_SYNC));
+    }
+}
+
+int P2PComm::CreateListenSocket(uint32_t listen_port_host, bool share_port)
+{
     int serv_sock = socket(AF_INET, SOCK_STREAM, 0);
     if (serv_sock < 0)
     {
         LOG_GENERAL(WARNING,
                     "Socket creation failed. Code = " << errno << " Desc: "
                                                       << std::strerror(errno));
-        return;
+        return -1;
     }
 
     int enable = 1;
@@ -676,11 +1160,30 @@ void P2PComm::StartMessagePump(uint32_t listen_port_host, Dispatcher dispatcher,
         LOG_GENERAL(WARNING,
                     "Socket set option SO_REUSEADDR failed. Code = "
                         << errno << " Desc: " << std::strerror(errno));
-        return;
+        evutil_closesocket(serv_sock);
+        return -1;
     }
 
-    m_dispatcher = dispatcher;
-    m_broadcast_list_retriever = broadcast_list_retriever;
+#ifdef SO_REUSEPORT
+    if (share_port
+        && setsockopt(serv_sock, SOL_SOCKET, SO_REUSEPORT, &enable,
+                      sizeof(int))
+            < 0)
+    {
+        LOG_GENERAL(WARNING,
+                    "Socket set option SO_REUSEPORT failed. Code = "
+                        << errno << " Desc: " << std::strerror(errno));
+        evutil_closesocket(serv_sock);
+        return -1;
+    }
+#else
+    if (share_port)
+    {
+        LOG_GENERAL(WARNING, "SO_REUSEPORT is not supported.");
+        evutil_closesocket(serv_sock);
+        return -1;
+    }
+#endif
 
     struct sockaddr_in serv_addr;
     memset(&serv_addr, 0, sizeof(struct sockaddr_in));
@@ -688,19 +1191,158 @@ void P2PComm::StartMessagePump(uint32_t listen_port_host, Dispatcher dispatcher,
     serv_addr.sin_port = htons(listen_port_host);
     serv_addr.sin_addr.s_addr = INADDR_ANY;
 
-    // Create the listener
-    struct event_base* base = event_base_new();
-    struct evconnlistener* listener = evconnlistener_new_bind(
-        base, AcceptConnectionCallback, nullptr,
-        LEV_OPT_REUSEABLE | LEV_OPT_CLOSE_ON_FREE, -1,
-        (struct sockaddr*)&serv_addr, sizeof(struct sockaddr_in));
-    event_base_dispatch(base);
-    evconnlistener_free(listener);
-    event_base_free(base);
+    if (bind(serv_sock, (struct sockaddr*)&serv_addr,
+             sizeof(struct sockaddr_in))
+            < 0
+        || listen(serv_sock, SOMAXCONN) < 0
+        || evutil_make_socket_nonblocking(serv_sock) < 0)
+    {
+        LOG_GENERAL(WARNING,
+                    "Socket bind/listen failed. Code = "
+                        << errno << " Desc: " << std::strerror(errno));
+        evutil_closesocket(serv_sock);
+        return -1;
+    }
+
+    return serv_sock;
+}
+
+void P2PComm::StartMessagePump(uint32_t listen_port_host, Dispatcher dispatcher,
+                               BroadcastListFunc broadcast_list_retriever,
+                               ReadyFunc ready_checker)
+{
+    LOG_MARKER();
+
+    // Launch the thread that reads messages from the send queue. It only
+    // takes a job once a sender is free, so that a burst of low priority
+    // jobs waits in the weighted queue instead of the pool's FIFO
+    auto funcCheckSendQueue = [this]() mutable -> void {
+        while (true)
+        {
+            {
+                unique_lock<mutex> lock(m_mutexSendJobsInFlight);
+                m_cvSendJobsInFlight.wait(lock, [this] {
+                    return m_sendJobsInFlight < MAXMESSAGE;
+                });
+            }
+
+            ProcessSendJob(m_sendQueue.Pop());
+        }
+    };
+    DetachedFunction(1, funcCheckSendQueue);
+
+    m_dispatcher = dispatcher;
+    m_broadcast_list_retriever = broadcast_list_retriever;
+    m_ready_checker = ready_checker;
+
+    // Every reactor runs its own event loop and listener; the kernel spreads
+    // incoming connections over the listeners sharing the port
+    unsigned int numReactors = max(NUM_EVENT_REACTORS, 1u);
+    vector<unique_ptr<Reactor>> reactors;
+
+    for (unsigned int i = 0; i < numReactors; i++)
+    {
+        int serv_sock = CreateListenSocket(listen_port_host, numReactors > 1);
+        if (serv_sock < 0 && i == 0 && numReactors > 1)
+        {
+            // Without a shared port only a single listener can bind it
+            LOG_GENERAL(WARNING,
+                        "Cannot share port " << listen_port_host
+                                             << ", using a single reactor");
+            numReactors = 1;
+            serv_sock = CreateListenSocket(listen_port_host, false);
+        }
+        if (serv_sock < 0)
+        {
+            break;
+        }
+
+        unique_ptr<Reactor> reactor(new Reactor);
+        reactor->m_id = i;
+        reactor->m_base = event_base_new();
+        if (reactor->m_base == NULL)
+        {
+            LOG_GENERAL(WARNING, "event_base_new failure for reactor " << i);
+            evutil_closesocket(serv_sock);
+            break;
+        }
+
+        reactor->m_listener = evconnlistener_new(
+            reactor->m_base, AcceptConnectionCallback, reactor.get(),
+            LEV_OPT_CLOSE_ON_FREE, -1, serv_sock);
+        if (reactor->m_listener == NULL)
+        {
+            LOG_GENERAL(WARNING,
+                        "evconnlistener_new failure for reactor " << i);
+            evutil_closesocket(serv_sock);
+            event_base_free(reactor->m_base);
+            break;
+        }
+
+        reactor->m_resumeTimer
+            = evtimer_new(reactor->m_base, ResumeConnections, reactor.get());
+        if (reactor->m_resumeTimer == NULL)
+        {
+            LOG_GENERAL(WARNING, "evtimer_new failure for reactor " << i);
+            evconnlistener_free(reactor->m_listener);
+            event_base_free(reactor->m_base);
+            break;
+        }
+
+        struct timeval interval = {REACTOR_STATS_SECONDS, 0};
+        reactor->m_statsTimer = event_new(reactor->m_base, -1, EV_PERSIST,
+                                          LogReactorStats, reactor.get());
+        if (reactor->m_statsTimer != NULL)
+        {
+            event_add(reactor->m_statsTimer, &interval);
+        }
+
+        reactors.emplace_back(move(reactor));
+    }
+
+    // The reactors set up so far still serve the port
+    if (reactors.empty())
+    {
+        LOG_GENERAL(WARNING, "Cannot listen on port " << listen_port_host);
+        return;
+    }
+
+    if (reactors.size() < numReactors)
+    {
+        LOG_GENERAL(WARNING,
+                    "Only " << reactors.size() << " of " << numReactors
+                            << " reactors could listen on port "
+                            << listen_port_host);
+    }
+
+    LOG_GENERAL(INFO,
+                "Listening on port " << listen_port_host << " with "
+                                     << reactors.size() << " reactors");
+
+    for (unsigned int i = 1; i < reactors.size(); i++)
+    {
+        Reactor* reactor = reactors.at(i).get();
+        DetachedFunction(
+            1, [reactor]() -> void { event_base_dispatch(reactor->m_base); });
+    }
+
+    event_base_dispatch(reactors.front()->m_base);
+
+    for (auto& reactor : reactors)
+    {
+        if (reactor->m_statsTimer != NULL)
+        {
+            event_free(reactor->m_statsTimer);
+        }
+        event_free(reactor->m_resumeTimer);
+        evconnlistener_free(reactor->m_listener);
+        event_base_free(reactor->m_base);
+    }
 }
 
 void P2PComm::SendMessage(const vector<Peer>& peers,
-                          const vector<unsigned char>& message)
+                          const vector<unsigned char>& message,
+                          const PeerSendCallback& callback)
 {
     LOG_MARKER();
 
@@ -712,20 +1354,19 @@ void P2PComm::SendMessage(const vector<Peer>& peers,
     // Make job
     SendJob* job = new SendJobPeers<vector<Peer>>;
     dynamic_cast<SendJobPeers<vector<Peer>>*>(job)->m_peers = peers;
+    dynamic_cast<SendJobPeers<vector<Peer>>*>(job)->m_callback = callback;
     job->m_selfPeer = m_selfPeer;
     job->m_startbyte = START_BYTE_NORMAL;
-    job->m_message = message;
+    job->m_message = PackMessage(message, job->m_startbyte);
     job->m_hash.clear();
 
     // Queue job
-    while (!m_sendQueue.push(job))
-    {
-        // Keep attempting to push until success
-    }
+    QueueSendJob(ClassifyMessage(message), job);
 }
 
 void P2PComm::SendMessage(const deque<Peer>& peers,
-                          const vector<unsigned char>& message)
+                          const vector<unsigned char>& message,
+                          const PeerSendCallback& callback)
 {
     LOG_MARKER();
 
@@ -737,16 +1378,14 @@ void P2PComm::SendMessage(const deque<Peer>& peers,
     // Make job
     SendJob* job = new SendJobPeers<deque<Peer>>;
     dynamic_cast<SendJobPeers<deque<Peer>>*>(job)->m_peers = peers;
+    dynamic_cast<SendJobPeers<deque<Peer>>*>(job)->m_callback = callback;
     job->m_selfPeer = m_selfPeer;
     job->m_startbyte = START_BYTE_NORMAL;
-    job->m_message = message;
+    job->m_message = PackMessage(message, job->m_startbyte);
     job->m_hash.clear();
 
     // Queue job
-    while (!m_sendQueue.push(job))
-    {
-        // Keep attempting to push until success
-    }
+    QueueSendJob(ClassifyMessage(message), job);
 }
 
 void P2PComm::SendMessage(const Peer& peer,
@@ -759,18 +1398,16 @@ void P2PComm::SendMessage(const Peer& peer,
     dynamic_cast<SendJobPeer*>(job)->m_peer = peer;
     job->m_selfPeer = m_selfPeer;
     job->m_startbyte = START_BYTE_NORMAL;
-    job->m_message = message;
+    job->m_message = PackMessage(message, job->m_startbyte);
     job->m_hash.clear();
 
     // Queue job
-    while (!m_sendQueue.push(job))
-    {
-        // Keep attempting to push until success
-    }
+    QueueSendJob(ClassifyMessage(message), job);
 }
 
 void P2PComm::SendBroadcastMessage(const vector<Peer>& peers,
-                                   const vector<unsigned char>& message)
+                                   const vector<unsigned char>& message,
+                                   const PeerSendCallback& callback)
 {
     LOG_MARKER();
 
@@ -779,29 +1416,41 @@ void P2PComm::SendBroadcastMessage(const vector<Peer>& peers,
         return;
     }
 
+    if (IsGossipEnabled(message))
+    {
+        Gossip::GetInstance().SpreadRumor(
+            vector<Peer>(peers.begin(), peers.end()), message);
+        return;
+    }
+
+    if (BROADCAST_GOSSIP_MODE)
+    {
+        Gossip::GetInstance().RecordFloodSent((HASH_LEN + message.size())
+                                              * peers.size());
+    }
+
     SHA2<HASH_TYPE::HASH_VARIANT_256> sha256;
     sha256.Update(message);
 
     // Make job
     SendJob* job = new SendJobPeers<vector<Peer>>;
     dynamic_cast<SendJobPeers<vector<Peer>>*>(job)->m_peers = peers;
+    dynamic_cast<SendJobPeers<vector<Peer>>*>(job)->m_callback = callback;
     job->m_selfPeer = m_selfPeer;
     job->m_startbyte = START_BYTE_BROADCAST;
-    job->m_message = message;
+    job->m_message = PackMessage(message, job->m_startbyte);
     job->m_hash = sha256.Finalize();
 
-    // Queue job
-    while (!m_sendQueue.push(job))
-    {
-        // Keep attempting to push until success
-    }
+    // Remember our own message before the job can be sent (and freed)
+    m_broadcastHashes.Insert(job->m_hash);
 
-    lock_guard<mutex> guard(m_broadcastHashesMutex);
-    m_broadcastHashes.insert(job->m_hash);
+    // Queue job
+    QueueSendJob(ClassifyMessage(message), job);
 }
 
 void P2PComm::SendBroadcastMessage(const deque<Peer>& peers,
-                                   const vector<unsigned char>& message)
+                                   const vector<unsigned char>& message,
+                                   const PeerSendCallback& callback)
 {
     LOG_MARKER();
 
@@ -810,25 +1459,36 @@ void P2PComm::SendBroadcastMessage(const deque<Peer>& peers,
         return;
     }
 
+    if (IsGossipEnabled(message))
+    {
+        Gossip::GetInstance().SpreadRumor(
+            vector<Peer>(peers.begin(), peers.end()), message);
+        return;
+    }
+
+    if (BROADCAST_GOSSIP_MODE)
+    {
+        Gossip::GetInstance().RecordFloodSent((HASH_LEN + message.size())
+                                              * peers.size());
+    }
+
     SHA2<HASH_TYPE::HASH_VARIANT_256> sha256;
     sha256.Update(message);
 
     // Make job
     SendJob* job = new SendJobPeers<deque<Peer>>;
     dynamic_cast<SendJobPeers<deque<Peer>>*>(job)->m_peers = peers;
+    dynamic_cast<SendJobPeers<deque<Peer>>*>(job)->m_callback = callback;
     job->m_selfPeer = m_selfPeer;
     job->m_startbyte = START_BYTE_BROADCAST;
-    job->m_message = message;
+    job->m_message = PackMessage(message, job->m_startbyte);
     job->m_hash = sha256.Finalize();
 
-    // Queue job
-    while (!m_sendQueue.push(job))
-    {
-        // Keep attempting to push until success
-    }
+    // Remember our own message before the job can be sent (and freed)
+    m_broadcastHashes.Insert(job->m_hash);
 
-    lock_guard<mutex> guard(m_broadcastHashesMutex);
-    m_broadcastHashes.insert(job->m_hash);
+    // Queue job
+    QueueSendJob(ClassifyMessage(message), job);
 }
 
 void P2PComm::RebroadcastMessage(const vector<Peer>& peers,
@@ -837,20 +1497,58 @@ void P2PComm::RebroadcastMessage(const vector<Peer>& peers,
 {
     LOG_MARKER();
 
+    if (BROADCAST_GOSSIP_MODE)
+    {
+        Gossip::GetInstance().RecordFloodSent((HASH_LEN + message.size())
+                                              * peers.size());
+    }
+
     // Make job
     SendJob* job = new SendJobPeers<vector<Peer>>;
     dynamic_cast<SendJobPeers<vector<Peer>>*>(job)->m_peers = peers;
     job->m_selfPeer = Peer();
     job->m_startbyte = START_BYTE_BROADCAST;
-    copy(message.begin() + HDR_LEN + HASH_LEN, message.end(),
-         back_inserter(job->m_message));
+    job->m_message = PackMessage(message, job->m_startbyte);
     job->m_hash = msg_hash;
 
     // Queue job
-    while (!m_sendQueue.push(job))
+    QueueSendJob(ClassifyMessage(message), job);
+}
+
+void P2PComm::SendGossipMessage(const vector<Peer>& peers,
+                                const SharedBuffer& message)
+{
+    // Make job
+    SendJob* job = new SendJobPeers<vector<Peer>>;
+    dynamic_cast<SendJobPeers<vector<Peer>>*>(job)->m_peers = peers;
+    job->m_selfPeer = Peer();
+    job->m_startbyte = START_BYTE_GOSSIP;
+    job->m_message = message;
+    job->m_hash.clear();
+
+    // Queue job
+    // Gossip frames wrap the message, and only peer broadcasts use them so far
+    QueueSendJob(SEND_SYNC, job);
+}
+
+void P2PComm::EnableGossip(unsigned char msg_type, unsigned char ins_type)
+{
+    lock_guard<mutex> g(m_mutexGossipInstructions);
+    m_gossipInstructions.emplace(msg_type, ins_type);
+}
+
+bool P2PComm::IsGossipEnabled(const vector<unsigned char>& message)
+{
+    if (message.size() <= MessageOffset::INST)
     {
-        // Keep attempting to push until success
+        return false;
     }
+
+    lock_guard<mutex> g(m_mutexGossipInstructions);
+    return m_gossipInstructions.find(
+               make_pair(message.at(MessageOffset::TYPE),
+                         message.at(MessageOffset::INST)))
+        != m_gossipInstructions.end();
 }
 
 void P2PComm::SendMessageNoQueue(const Peer& peer,
@@ -867,7 +1565,10 @@ void P2PComm::SendMessageNoQueue(const Peer& peer,
         return;
     }
 
-    SendJob::SendMessageCore(peer, message, START_BYTE_NORMAL, {});
+    // One-shot senders (e.g. sendcmd) exit right away, so never pool here
+    SendJob::SendMessageCore(peer, message, START_BYTE_NORMAL, {}, false);
 }
 
 void P2PComm::SetSelfPeer(const Peer& self) { m_selfPeer = self; }
+
+const Peer& P2PComm::GetSelfPeer() const { return m_selfPeer; }
@@ -17,20 +17,43 @@
 #ifndef __P2PCOMM_H__
 #define __P2PCOMM_H__
 
-#include <boost/lockfree/queue.hpp>
+#include <condition_variable>
 #include <deque>
 #include <event2/util.h>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <vector>
 
+#include "BroadcastHashStore.h"
 #include "Peer.h"
 #include "common/Constants.h"
 #include "libUtils/Logger.h"
 #include "libUtils/ThreadPool.h"
+#include "libUtils/WeightedJobQueue.h"
 
 struct evconnlistener;
+struct iovec;
+struct MulticastState;
+struct MulticastRound;
+class Scheduler;
+
+/// Classes of service for outbound messages, in scheduling order.
+enum SendClass : unsigned int
+{
+    SEND_CONSENSUS = 0,
+    SEND_BLOCK,
+    SEND_TRANSACTION,
+    SEND_SYNC,
+    NUM_SEND_CLASSES
+};
+
+/// Immutable message payload, shared by every job and peer it is sent to.
+using SharedBuffer = std::shared_ptr<const std::vector<unsigned char>>;
+
+/// Reports whether a multicast message reached one of its peers (called from the sending threads).
+using PeerSendCallback = std::function<void(const Peer& peer, bool delivered)>;
 
 class SendJob
 {
@@ -38,55 +61,64 @@ protected:
     static const uint32_t MAXRETRYCONN = 3;
     static const uint32_t PUMPMESSAGE_MILLISECONDS = 1000;
 
-    static uint32_t writeMsg(const void* buf, int cli_sock, const Peer& from,
-                             const uint32_t message_length);
+    static WeightedJobQueue<std::function<void()>>&
+    GetMulticastQueue();
+    static Scheduler& GetRetryScheduler();
+    static void StartMulticastRound(const std::shared_ptr<MulticastState>& state,
+                                    std::vector<Peer>&& peers,
+                                    unsigned int retry);
+    static void RunMulticastLane(const std::shared_ptr<MulticastRound>& round);
+    static void EndMulticastRound(const std::shared_ptr<MulticastRound>& round);
+    static void FinishMulticast(const std::shared_ptr<MulticastState>& state);
+
+    static bool writeMsg(struct iovec* iov, int iovcnt, int cli_sock,
+                         const Peer& from);
     static bool SendMessageSocketCore(
         const Peer& peer, const std::vector<unsigned char>& message,
-        unsigned char start_byte, const std::vector<unsigned char>& msg_hash);
+        unsigned char start_byte, const std::vector<unsigned char>& msg_hash,
+        bool persistent);
 
 public:
     Peer m_selfPeer;
     unsigned char m_startbyte;
-    std::vector<unsigned char> m_message;
+    SharedBuffer m_message;
     std::vector<unsigned char> m_hash;
+    SendClass m_class;
 
     static void SendMessageCore(const Peer& peer,
-                                const std::vector<unsigned char> message,
+                                const std::vector<unsigned char>& message,
                                 unsigned char startbyte,
-                                const std::vector<unsigned char> hash);
+                                const std::vector<unsigned char>& hash,
+                                bool persistent);
 
     virtual ~SendJob() {}
-    virtual void DoSend() = 0;
+
+    /// Sends the message and calls done once the last peer is served, possibly from another thread.
+    virtual void DoSend(const std::function<void()>& done) = 0;
 };
 
 class SendJobPeer : public SendJob
 {
 public:
     Peer m_peer;
-    void DoSend();
+    void DoSend(const std::function<void()>& done);
 };
 
 template<class T> class SendJobPeers : public SendJob
 {
 public:
     T m_peers;
-    void DoSend();
+    PeerSendCallback m_callback;
+    void DoSend(const std::function<void()>& done);
 };
 
 /// Provides network layer functionality.
 class P2PComm
 {
-    std::set<std::vector<unsigned char>> m_broadcastHashes;
-    std::mutex m_broadcastHashesMutex;
-    std::deque<std::pair<std::vector<unsigned char>,
-                         std::chrono::time_point<std::chrono::system_clock>>>
-        m_broadcastToRemove;
-    std::mutex m_broadcastToRemoveMutex;
+    BroadcastHashStore m_broadcastHashes;
 
     const static uint32_t MAXPUMPMESSAGE = 128;
-
-    void
-    ClearBroadcastHashAsync(const std::vector<unsigned char>& message_hash);
+    const static long REACTOR_STATS_SECONDS = 60;
 
     P2PComm();
     ~P2PComm();
@@ -100,12 +132,29 @@ class P2PComm
 
     Peer m_selfPeer;
 
+    std::set<std::pair<unsigned char, unsigned char>> m_gossipInstructions;
+    std::mutex m_mutexGossipInstructions;
+    bool IsGossipEnabled(const std::vector<unsigned char>& message);
+
     ThreadPool m_SendPool{MAXMESSAGE, "SendPool"};
 
-    boost::lockfree::queue<SendJob*> m_sendQueue;
+    WeightedJobQueue<SendJob*> m_sendQueue;
+    unsigned int m_sendJobsInFlight;
+    std::mutex m_mutexSendJobsInFlight;
+    std::condition_variable m_cvSendJobsInFlight;
+    void QueueSendJob(SendClass cls, SendJob* job);
     void ProcessSendJob(SendJob* job);
 
     static void EventCallback(struct bufferevent* bev, short events, void* ctx);
+    static void ReadCallback(struct bufferevent* bev, void* ctx);
+    static bool
+    ProcessBroadcastMessage(std::vector<unsigned char>& message,
+                            const std::vector<unsigned char>& msg_hash,
+                            const Peer& from);
+    static bool IsReady(unsigned char msg_type);
+    static void ResumeConnections(evutil_socket_t fd, short events, void* arg);
+    static void LogReactorStats(evutil_socket_t fd, short events, void* arg);
+    static int CreateListenSocket(uint32_t listen_port_host, bool share_port);
     static void AcceptConnectionCallback(evconnlistener* listener,
                                          evutil_socket_t cli_sock,
                                          struct sockaddr* cli_addr, int socklen,
@@ -121,10 +170,14 @@ public:
     using BroadcastListFunc = std::function<std::vector<Peer>(
         unsigned char msg_type, unsigned char ins_type, const Peer&)>;
 
+    /// Returns false while messages of msg_type are backed up, so that their senders should be paused.
+    using ReadyFunc = std::function<bool(unsigned char msg_type)>;
+
 private:
     using SocketCloser = std::unique_ptr<int, void (*)(int*)>;
     static Dispatcher m_dispatcher;
     static BroadcastListFunc m_broadcast_list_retriever;
+    static ReadyFunc m_ready_checker;
 
 public:
     /// Accept TCP connection for libevent usage
@@ -134,16 +187,20 @@ public:
                                  void* arg);
 
     /// Listens for incoming socket connections.
+    /// A connection that delivers a message of a type ready_checker reports as backed up stops being read until that type drains.
     void StartMessagePump(uint32_t listen_port_host, Dispatcher dispatcher,
-                          BroadcastListFunc broadcast_list_retriever);
+                          BroadcastListFunc broadcast_list_retriever,
+                          ReadyFunc ready_checker = nullptr);
 
     /// Multicasts message to specified list of peers.
     void SendMessage(const std::vector<Peer>& peers,
-                     const std::vector<unsigned char>& message);
+                     const std::vector<unsigned char>& message,
+                     const PeerSendCallback& callback = nullptr);
 
     /// Multicasts message to specified list of peers.
     void SendMessage(const std::deque<Peer>& peers,
-                     const std::vector<unsigned char>& message);
+                     const std::vector<unsigned char>& message,
+                     const PeerSendCallback& callback = nullptr);
 
     /// Sends message to specified peer.
     void SendMessage(const Peer& peer,
@@ -151,20 +208,38 @@ public:
 
     /// Multicasts message of type=broadcast to specified list of peers.
     void SendBroadcastMessage(const std::vector<Peer>& peers,
-                              const std::vector<unsigned char>& message);
+                              const std::vector<unsigned char>& message,
+                              const PeerSendCallback& callback = nullptr);
 
     /// Multicasts message of type=broadcast to specified list of peers.
     void SendBroadcastMessage(const std::deque<Peer>& peers,
-                              const std::vector<unsigned char>& message);
+                              const std::vector<unsigned char>& message,
+                              const PeerSendCallback& callback = nullptr);
 
+    /// Multicasts an already hashed broadcast message body to specified list of peers.
     void RebroadcastMessage(const std::vector<Peer>& peers,
                             const std::vector<unsigned char>& message,
                             const std::vector<unsigned char>& msg_hash);
 
+    /// Multicasts an already framed gossip message to specified list of peers.
+    void SendGossipMessage(const std::vector<Peer>& peers,
+                           const SharedBuffer& message);
+
+    /// Spreads broadcasts of the specified message and instruction type by gossip instead of flooding.
+    void EnableGossip(unsigned char msg_type, unsigned char ins_type);
+
     void SendMessageNoQueue(const Peer& peer,
                             const std::vector<unsigned char>& message);
 
     void SetSelfPeer(const Peer& self);
+
+    const Peer& GetSelfPeer() const;
+
+    /// Returns the number of queued outbound jobs per SendClass.
+    std::vector<size_t> GetSendQueueDepths();
+
+    /// Classifies a message by its type and instruction bytes.
+    static SendClass ClassifyMessage(const std::vector<unsigned char>& message);
 };
 
 #endif // __P2PCOMM_H__
@@ -186,6 +186,12 @@ PeerManager::PeerManager(const std::pair<PrivKey, PubKey>& key,
     LOG_MARKER();
     SetupLogLevel();
 
+    if (BROADCAST_GOSSIP_MODE)
+    {
+        P2PComm::GetInstance().EnableGossip(MessageType::PEER,
+                                            InstructionType::BROADCAST);
+    }
+
     if (loadConfig)
     {
         LOG_GENERAL(INFO, "Loading configuration file");
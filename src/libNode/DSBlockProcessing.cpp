@@ -153,9 +153,9 @@ bool Node::VerifyDSBlockCoSignature(const DSBlock& dsblock)
     vector<PubKey> keys;
     for (auto const& kv : *m_mediator.m_DSCommittee)
     {
+        keys.emplace_back(kv.first);
         if (B2.at(index) == true)
         {
-            keys.emplace_back(kv.first);
             count++;
         }
         index++;
@@ -167,7 +167,7 @@ bool Node::VerifyDSBlockCoSignature(const DSBlock& dsblock)
         return false;
     }
 
-    shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+    shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys, B2);
     if (aggregatedKey == nullptr)
     {
         LOG_GENERAL(WARNING, "Aggregated key generation failed");
@@ -185,9 +185,12 @@ bool Node::VerifyDSBlockCoSignature(const DSBlock& dsblock)
         == false)
     {
         LOG_GENERAL(WARNING, "Cosig verification failed");
-        for (auto& kv : keys)
+        for (unsigned int i = 0; i < keys.size(); i++)
         {
-            LOG_GENERAL(WARNING, kv);
+            if (B2.at(i) == true)
+            {
+                LOG_GENERAL(WARNING, keys.at(i));
+            }
         }
         return false;
     }
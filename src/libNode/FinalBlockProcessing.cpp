@@ -283,9 +283,9 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock)
     vector<PubKey> keys;
     for (auto const& kv : *m_mediator.m_DSCommittee)
     {
+        keys.emplace_back(kv.first);
         if (B2.at(index) == true)
         {
-            keys.emplace_back(kv.first);
             count++;
         }
         index++;
@@ -297,7 +297,7 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock)
         return false;
     }
 
-    shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+    shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys, B2);
     if (aggregatedKey == nullptr)
     {
         LOG_GENERAL(WARNING, "Aggregated key generation failed");
@@ -315,9 +315,12 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock)
         == false)
     {
         LOG_GENERAL(WARNING, "Cosig verification failed");
-        for (auto& kv : keys)
+        for (unsigned int i = 0; i < keys.size(); i++)
         {
-            LOG_GENERAL(WARNING, kv);
+            if (B2.at(i) == true)
+            {
+                LOG_GENERAL(WARNING, keys.at(i));
+            }
         }
         return false;
     }
@@ -884,6 +887,7 @@ bool Node::ProcessFinalBlock(const vector<unsigned char>& message,
                   "I may have missed the micrblock consensus. However, if I "
                   "recently received a valid finalblock, I will accept it");
         // TODO: Optimize state transition.
+        m_txnSequencer.Drain();
         AccountStore::GetInstance().InitTemp();
         SetState(WAITING_FINALBLOCK);
     }
@@ -1086,7 +1090,10 @@ bool Node::ProcessStateDeltaFromFinalBlock(
     }
 
     // Deserialize State Delta
-    // Init local AccountStoreTemp first
+    // Init local AccountStoreTemp first, once no queued txn can touch it
+#ifndef IS_LOOKUP_NODE
+    m_txnSequencer.Drain();
+#endif // IS_LOOKUP_NODE
     AccountStore::GetInstance().InitTemp();
 
     if (finalBlockStateDeltaHash == StateHash())
@@ -183,7 +183,12 @@ bool Node::ProcessMicroblockConsensus(
         return false;
     }
 
-    lock_guard<mutex> g(m_mutexConsensus);
+    std::unique_lock<mutex> g(m_mutexConsensus, std::defer_lock);
+    if (!ConsensusCommon::PreProcessInOrder(cv_lk, g, m_consensusObject,
+                                            message, offset, from))
+    {
+        return false;
+    }
 
     if (!m_consensusObject->ProcessMessage(message, offset, from))
     {
@@ -620,6 +625,9 @@ bool Node::RunConsensusOnMicroBlock()
 
     SetState(MICROBLOCK_CONSENSUS_PREP);
 
+    // Txns that arrived during submission must be in the delta and microblock
+    m_txnSequencer.Drain();
+
     AccountStore::GetInstance().SerializeDelta();
 
     {
@@ -546,20 +546,20 @@ bool Node::ProcessSubmitMissingTxn(const vector<unsigned char>& message,
                       << " , local: " << m_mediator.m_currentEpochNum);
     }
 
-    while (cur_offset < message.size())
-    {
-        Transaction submittedTransaction;
-        if (submittedTransaction.Deserialize(message, cur_offset) != 0)
-        {
-            LOG_GENERAL(WARNING,
-                        "Deserialize transactions failed, stop at the previous "
-                        "successful one");
-            return false;
-        }
-        cur_offset += submittedTransaction.GetSerializedSize();
+    vector<Transaction> submittedTransactions;
+    bool result = LoadSubmittedTxns(message, cur_offset, submittedTransactions);
 
-        if (m_mediator.m_validator->CheckCreatedTransaction(
-                submittedTransaction))
+    // Checked right here rather than on the sequencer: the microblock
+    // consensus is waiting for these with a timeout, and must not queue
+    // behind the txn sharing backlog
+    vector<bool> checked;
+    m_mediator.m_validator->CheckCreatedTransactions(submittedTransactions,
+                                                     checked);
+
+    for (unsigned int i = 0; i < submittedTransactions.size(); i++)
+    {
+        const auto& submittedTransaction = submittedTransactions.at(i);
+        if (checked.at(i))
         {
             uint64_t blockNum = m_mediator.m_currentEpochNum;
             lock_guard<mutex> g(m_mutexReceivedTransactions);
@@ -574,7 +574,57 @@ bool Node::ProcessSubmitMissingTxn(const vector<unsigned char>& message,
 
     AccountStore::GetInstance().SerializeDelta();
     cv_MicroBlockMissingTxn.notify_all();
-    return true;
+
+    return result;
+}
+
+bool Node::LoadSubmittedTxns(const vector<unsigned char>& message,
+                             unsigned int offset, vector<Transaction>& txns)
+{
+    unsigned int cur_offset = offset;
+    bool result = true;
+
+    while (cur_offset < message.size())
+    {
+        Transaction submittedTransaction;
+        if (submittedTransaction.Deserialize(message, cur_offset) != 0)
+        {
+            LOG_GENERAL(WARNING,
+                        "Deserialize transactions failed, stop at the previous "
+                        "successful one");
+            result = false;
+            break;
+        }
+        cur_offset += submittedTransaction.GetSerializedSize();
+        txns.emplace_back(move(submittedTransaction));
+    }
+
+    // Check the signatures of the whole packet at once
+    vector<bool> verified;
+    if (!m_mediator.m_validator->VerifyTransactions(txns, verified))
+    {
+        unsigned int kept = 0;
+        for (unsigned int i = 0; i < txns.size(); i++)
+        {
+            if (verified.at(i))
+            {
+                if (kept != i)
+                {
+                    txns.at(kept) = move(txns.at(i));
+                }
+                kept++;
+            }
+            else
+            {
+                LOG_GENERAL(WARNING,
+                            "Signature check failed for txn "
+                                << txns.at(i).GetTranID());
+            }
+        }
+        txns.resize(kept);
+    }
+
+    return result;
 }
 
 bool Node::ProcessSubmitTxnSharing(const vector<unsigned char>& message,
@@ -624,35 +674,44 @@ bool Node::ProcessSubmitTxnSharing(const vector<unsigned char>& message,
         }
     }
 
-    unsigned int cur_offset = offset;
+    // The packet belongs to the epoch it arrived in, not the one its job runs in
+    const uint64_t epochNum = m_mediator.m_currentEpochNum;
+    Sequencer::ScopedTicket ticket(m_txnSequencer);
 
-    while (cur_offset < message.size())
-    {
-        Transaction submittedTransaction;
-        if (submittedTransaction.Deserialize(message, cur_offset) != 0)
+    vector<Transaction> submittedTransactions;
+    bool result = LoadSubmittedTxns(message, offset, submittedTransactions);
+
+    ticket.Submit([this, epochNum, submittedTransactions
+                   = move(submittedTransactions)]() {
+        if (epochNum != m_mediator.m_currentEpochNum)
         {
-            LOG_GENERAL(WARNING,
-                        "Deserialize transactions failed, stop at the previous "
-                        "successful one");
-            return false;
+            LOG_EPOCH(WARNING, to_string(m_mediator.m_currentEpochNum).c_str(),
+                      "Dropping " << submittedTransactions.size()
+                                  << " shared txns of epoch " << epochNum);
+            return;
         }
-        cur_offset += submittedTransaction.GetSerializedSize();
 
-        if (m_mediator.m_validator->CheckCreatedTransaction(
-                submittedTransaction))
+        vector<bool> checked;
+        m_mediator.m_validator->CheckCreatedTransactions(submittedTransactions,
+                                                         checked);
+
+        for (unsigned int i = 0; i < submittedTransactions.size(); i++)
         {
-            lock_guard<mutex> g(m_mutexReceivedTransactions);
-            auto& receivedTransactions
-                = m_receivedTransactions[m_mediator.m_currentEpochNum];
+            const auto& submittedTransaction = submittedTransactions.at(i);
+            if (checked.at(i))
+            {
+                lock_guard<mutex> g(m_mutexReceivedTransactions);
+                auto& receivedTransactions = m_receivedTransactions[epochNum];
 
-            receivedTransactions.emplace(submittedTransaction.GetTranID(),
-                                         submittedTransaction);
-            //LOG_EPOCH(to_string(m_mediator.m_currentEpochNum).c_str(),
-            //             "Received txn: " << submittedTransaction.GetTranID())
+                receivedTransactions.emplace(submittedTransaction.GetTranID(),
+                                             submittedTransaction);
+                //LOG_EPOCH(to_string(m_mediator.m_currentEpochNum).c_str(),
+                //             "Received txn: " << submittedTransaction.GetTranID())
+            }
         }
-    }
+    });
 
-    return true;
+    return result;
 }
 #endif // IS_LOOKUP_NODE
 
@@ -726,6 +785,10 @@ bool Node::ProcessCreateTransactionFromLookup(
 
     unsigned int curr_offset = offset;
 
+    // Keep the arrival order for the nonce checks
+    const uint64_t epochNum = m_mediator.m_currentEpochNum;
+    Sequencer::ScopedTicket ticket(m_txnSequencer);
+
     // Transaction tx(message, curr_offset);
     Transaction tx;
     if (tx.Deserialize(message, curr_offset) != 0)
@@ -734,22 +797,30 @@ bool Node::ProcessCreateTransactionFromLookup(
         return false;
     }
 
-    lock_guard<mutex> g(m_mutexCreatedTransactions);
-
-    LOG_EPOCH(INFO, to_string(m_mediator.m_currentEpochNum).c_str(),
-              "Recvd txns: " << tx.GetTranID()
-                             << " Signature: " << tx.GetSignature()
-                             << " toAddr: " << tx.GetToAddr().hex());
-    if (m_mediator.m_validator->CheckCreatedTransactionFromLookup(tx))
-    {
-        m_createdTransactions.emplace_back(tx);
-    }
-    else
+    if (!m_mediator.m_validator->VerifyTransaction(tx))
     {
-        LOG_GENERAL(WARNING, "Txn is not valid.");
+        LOG_GENERAL(WARNING,
+                    "Signature check failed for txn " << tx.GetTranID());
         return false;
     }
 
+    ticket.Submit([this, epochNum, tx = move(tx)]() {
+        lock_guard<mutex> g(m_mutexCreatedTransactions);
+
+        LOG_EPOCH(INFO, to_string(epochNum).c_str(),
+                  "Recvd txns: " << tx.GetTranID()
+                                 << " Signature: " << tx.GetSignature()
+                                 << " toAddr: " << tx.GetToAddr().hex());
+        if (m_mediator.m_validator->CheckCreatedTransactionFromLookup(tx))
+        {
+            m_createdTransactions.emplace_back(tx);
+        }
+        else
+        {
+            LOG_GENERAL(WARNING, "Txn is not valid.");
+        }
+    });
+
 #endif //IS_LOOKUP_NODE
 
     return true;
@@ -39,6 +39,7 @@
 #include "libNetwork/PeerStore.h"
 #include "libPOW/pow.h"
 #include "libPersistence/BlockStorage.h"
+#include "libUtils/Sequencer.h"
 
 class Mediator;
 class Retriever;
@@ -148,6 +149,12 @@ class Node : public Executable, public Broadcastable
     std::unordered_map<uint64_t, std::vector<std::vector<unsigned char>>>
         m_forwardedTxnBuffer;
 
+#ifndef IS_LOOKUP_NODE
+    // Applies the stateful checks of incoming txns in arrival order,
+    // after their signatures have been verified in parallel
+    Sequencer m_txnSequencer;
+#endif // IS_LOOKUP_NODE
+
     atomic<bool> m_isVacuousEpoch;
 
     bool CheckState(Action action);
@@ -167,6 +174,9 @@ class Node : public Executable, public Broadcastable
                                  unsigned int offset, const Peer& from);
     bool ProcessSubmitTxnSharing(const vector<unsigned char>& message,
                                  unsigned int offset, const Peer& from);
+    // Deserializes a packet of txns and drops those with invalid signatures
+    bool LoadSubmittedTxns(const vector<unsigned char>& message,
+                           unsigned int offset, vector<Transaction>& txns);
 
     // internal calls from ActOnMicroBlock for NODE_FORWARD_ONLY and SEND_AND_FORWARD
     void LoadForwardingAssignment(const vector<Peer>& fellowForwarderNodes,
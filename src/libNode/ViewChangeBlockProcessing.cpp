@@ -117,9 +117,9 @@ bool Node::VerifyVCBlockCoSignature(const VCBlock& vcblock)
 
     for (auto const& kv : *m_mediator.m_DSCommittee)
     {
+        keys.emplace_back(kv.first);
         if (B2.at(index) == true)
         {
-            keys.emplace_back(kv.first);
             count++;
         }
         index++;
@@ -131,7 +131,7 @@ bool Node::VerifyVCBlockCoSignature(const VCBlock& vcblock)
         return false;
     }
 
-    shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+    shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys, B2);
     if (aggregatedKey == nullptr)
     {
         LOG_GENERAL(WARNING, "Aggregated key generation failed");
@@ -149,9 +149,12 @@ bool Node::VerifyVCBlockCoSignature(const VCBlock& vcblock)
         == false)
     {
         LOG_GENERAL(WARNING, "Cosig verification failed. Pubkeys");
-        for (auto& kv : keys)
+        for (unsigned int i = 0; i < keys.size(); i++)
         {
-            LOG_GENERAL(WARNING, kv);
+            if (B2.at(i) == true)
+            {
+                LOG_GENERAL(WARNING, keys.at(i));
+            }
         }
         return false;
     }
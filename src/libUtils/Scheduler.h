@@ -28,7 +28,7 @@
 // CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
 // threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
 
-/// [TODO] Currently unused
+/// Runs functions at or after a given time, one at a time on the thread that calls ServiceQueue.
 class Scheduler
 {
 public:
@@ -0,0 +1,173 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#ifndef __SEQUENCER_H__
+#define __SEQUENCER_H__
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+/**
+ * Runs jobs one at a time on a dedicated thread, in the order their tickets were reserved.
+ * Callers take a ticket when work arrives, do their stateless (and possibly parallel)
+ * preparation, then submit the job under that ticket. A job only runs once every
+ * earlier ticket has been submitted or skipped, so the stateful part stays deterministic.
+ */
+class Sequencer
+{
+public:
+    typedef uint64_t Ticket;
+    typedef std::function<void()> Job;
+
+    /// Constructor. Starts the sequencer thread.
+    Sequencer()
+        : m_nextTicket(0)
+        , m_nextToRun(0)
+        , m_bailout(false)
+    {
+        m_thread = std::thread([this] { this->Run(); });
+    }
+
+    /// Destructor. Runs the jobs that are already in order, then stops.
+    ~Sequencer()
+    {
+        {
+            std::lock_guard<std::mutex> g(m_mutex);
+            m_bailout = true;
+        }
+        m_cvReady.notify_all();
+        m_cvDone.notify_all();
+        m_thread.join();
+    }
+
+    Sequencer(Sequencer const&) = delete;
+    void operator=(Sequencer const&) = delete;
+
+    /// Takes the next slot in arrival order. Every ticket must be submitted or skipped.
+    Ticket Reserve()
+    {
+        std::lock_guard<std::mutex> g(m_mutex);
+        return m_nextTicket++;
+    }
+
+    /// Hands over the job for a reserved ticket.
+    void Submit(Ticket ticket, Job job)
+    {
+        {
+            std::lock_guard<std::mutex> g(m_mutex);
+            m_ready.emplace(ticket, std::move(job));
+        }
+        m_cvReady.notify_one();
+    }
+
+    /// Releases a reserved ticket without any work attached.
+    void Skip(Ticket ticket) { Submit(ticket, nullptr); }
+
+    /// Blocks until every ticket reserved before the call has run or been skipped. Must not be called from a job.
+    void Drain()
+    {
+        std::unique_lock<std::mutex> g(m_mutex);
+        const Ticket last = m_nextTicket;
+        m_cvDone.wait(g, [this, last] {
+            return m_bailout || m_nextToRun >= last;
+        });
+    }
+
+    /// Reserved ticket that is skipped when it goes out of scope unsubmitted, e.g. on an early return or exception.
+    class ScopedTicket
+    {
+    public:
+        explicit ScopedTicket(Sequencer& sequencer)
+            : m_sequencer(sequencer)
+            , m_ticket(sequencer.Reserve())
+            , m_submitted(false)
+        {
+        }
+
+        ~ScopedTicket()
+        {
+            if (!m_submitted)
+            {
+                m_sequencer.Skip(m_ticket);
+            }
+        }
+
+        ScopedTicket(ScopedTicket const&) = delete;
+        void operator=(ScopedTicket const&) = delete;
+
+        /// Hands over the job for this ticket, at most once.
+        void Submit(Job job)
+        {
+            m_submitted = true;
+            m_sequencer.Submit(m_ticket, std::move(job));
+        }
+
+    private:
+        Sequencer& m_sequencer;
+        Ticket m_ticket;
+        bool m_submitted;
+    };
+
+private:
+    void Run()
+    {
+        std::unique_lock<std::mutex> g(m_mutex);
+
+        while (true)
+        {
+            m_cvReady.wait(g, [this] {
+                return m_bailout
+                    || (!m_ready.empty()
+                        && m_ready.begin()->first == m_nextToRun);
+            });
+
+            if (m_ready.empty() || m_ready.begin()->first != m_nextToRun)
+            {
+                // Bailing out with nothing runnable left
+                return;
+            }
+
+            Job job = std::move(m_ready.begin()->second);
+            m_ready.erase(m_ready.begin());
+
+            g.unlock();
+            if (job)
+            {
+                job();
+            }
+            g.lock();
+
+            m_nextToRun++;
+            m_cvDone.notify_all();
+        }
+    }
+
+    Ticket m_nextTicket;
+    Ticket m_nextToRun;
+    bool m_bailout;
+    std::map<Ticket, Job> m_ready;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cvReady;
+    std::condition_variable m_cvDone;
+    std::thread m_thread;
+};
+
+#endif // __SEQUENCER_H__
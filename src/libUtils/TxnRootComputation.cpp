@@ -56,12 +56,14 @@ TxnHash ConcatTranAndHash(const Container&... conts)
         [](const auto& list, decltype(sha2)& sha2) {
             for (auto& item : list)
             {
-                sha2.Update(GetTranID(item).asBytes());
+                sha2.Update(GetTranID(item).asArray());
             }
         }(conts, sha2),
         0)...};
 
-    return TxnHash{sha2.Finalize()};
+    TxnHash hash;
+    sha2.Finalize(hash.asArray());
+    return hash;
 }
 
 template<typename... Container>
@@ -75,12 +77,14 @@ TxnHash ConcatStateAndHash(const Container&... conts)
         [](const auto& list, decltype(sha2)& sha2) {
             for (auto& item : list)
             {
-                sha2.Update(GetStateID(item).asBytes());
+                sha2.Update(GetStateID(item).asArray());
             }
         }(conts, sha2),
         0)...};
 
-    return TxnHash{sha2.Finalize()};
+    TxnHash hash;
+    sha2.Finalize(hash.asArray());
+    return hash;
 }
 
 TxnHash ComputeTransactionsRoot(const std::vector<TxnHash>& transactionHashes)
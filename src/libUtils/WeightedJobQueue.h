@@ -0,0 +1,150 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#ifndef __WEIGHTEDJOBQUEUE_H__
+#define __WEIGHTEDJOBQUEUE_H__
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+ * Bounded multi-class job queue. Pop serves the classes in weighted round robin,
+ * so a class with weight w gets up to w jobs out for each turn of the others.
+ * Push blocks while the job's class is at its limit, pushing back on that producer only.
+ */
+template<class T> class WeightedJobQueue
+{
+    struct Class
+    {
+        std::deque<T> m_jobs;
+        unsigned int m_weight;
+        size_t m_limit;
+        size_t m_peak;
+    };
+
+    std::vector<Class> m_classes;
+    unsigned int m_current;
+    unsigned int m_served;
+    size_t m_size;
+
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+
+    T TakeNext()
+    {
+        // Stay on the current class until its turn is used up or it runs dry
+        while (m_classes[m_current].m_jobs.empty()
+               || m_served >= m_classes[m_current].m_weight)
+        {
+            m_current = (m_current + 1) % m_classes.size();
+            m_served = 0;
+        }
+
+        Class& c = m_classes[m_current];
+        T job = c.m_jobs.front();
+        c.m_jobs.pop_front();
+        m_served++;
+        m_size--;
+
+        // Waiters of several classes share the condition, wake them all to recheck
+        m_notFull.notify_all();
+        return job;
+    }
+
+public:
+    /// Creates one class per weight, each holding at most the matching limit of jobs.
+    WeightedJobQueue(const std::vector<unsigned int>& weights,
+                     const std::vector<size_t>& limits)
+        : m_current(0)
+        , m_served(0)
+        , m_size(0)
+    {
+        m_classes.resize(weights.size());
+        for (unsigned int i = 0; i < m_classes.size(); i++)
+        {
+            m_classes[i].m_weight = std::max(weights[i], 1u);
+            m_classes[i].m_limit = i < limits.size()
+                ? std::max(limits[i], (size_t)1)
+                : (size_t)1;
+            m_classes[i].m_peak = 0;
+        }
+    }
+
+    /// Adds the job to its class, waiting while that class is full.
+    void Push(unsigned int cls, const T& job)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Class& c = m_classes.at(cls);
+
+        m_notFull.wait(lock,
+                       [&c] { return c.m_jobs.size() < c.m_limit; });
+
+        c.m_jobs.push_back(job);
+        c.m_peak = std::max(c.m_peak, c.m_jobs.size());
+        m_size++;
+        m_notEmpty.notify_one();
+    }
+
+    /// Takes the next job by weighted round robin, waiting while all classes are empty.
+    T Pop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return m_size > 0; });
+        return TakeNext();
+    }
+
+    /// Takes the next job like Pop, but returns false instead of waiting when empty.
+    bool TryPop(T& job)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_size == 0)
+        {
+            return false;
+        }
+        job = TakeNext();
+        return true;
+    }
+
+    /// Returns the current number of queued jobs per class.
+    std::vector<size_t> Depths()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<size_t> depths;
+        for (const auto& c : m_classes)
+        {
+            depths.emplace_back(c.m_jobs.size());
+        }
+        return depths;
+    }
+
+    /// Returns the highest number of queued jobs per class seen so far.
+    std::vector<size_t> PeakDepths()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<size_t> peaks;
+        for (const auto& c : m_classes)
+        {
+            peaks.emplace_back(c.m_peak);
+        }
+        return peaks;
+    }
+};
+
+#endif // __WEIGHTEDJOBQUEUE_H__
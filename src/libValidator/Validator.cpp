@@ -39,6 +39,23 @@ bool Validator::VerifyTransaction(const Transaction& tran) const
                                          tran.GetSenderPubKey());
 }
 
+bool Validator::VerifyTransactions(const vector<Transaction>& txns,
+                                   vector<bool>& results) const
+{
+    vector<vector<unsigned char>> txnData(txns.size());
+    vector<SignedMessageRef> batch;
+    batch.reserve(txns.size());
+
+    for (unsigned int i = 0; i < txns.size(); i++)
+    {
+        txns.at(i).SerializeCoreFields(txnData.at(i), 0);
+        batch.emplace_back(txnData.at(i), txns.at(i).GetSignature(),
+                           txns.at(i).GetSenderPubKey());
+    }
+
+    return Schnorr::GetInstance().BatchVerify(batch, results);
+}
+
 void Validator::CleanVariables()
 {
     // Clear m_txnNonceMap
@@ -49,7 +66,7 @@ void Validator::CleanVariables()
 }
 
 #ifndef IS_LOOKUP_NODE
-bool Validator::CheckCreatedTransaction(const Transaction& tx) const
+bool Validator::CheckTransactionSender(const Transaction& tx) const
 {
     // LOG_MARKER();
 
@@ -105,8 +122,30 @@ bool Validator::CheckCreatedTransaction(const Transaction& tx) const
         return false;
     }
 
-    return AccountStore::GetInstance().UpdateAccountsTemp(
-        m_mediator.m_currentEpochNum, tx);
+    return true;
+}
+
+bool Validator::CheckCreatedTransaction(const Transaction& tx) const
+{
+    return CheckTransactionSender(tx)
+        && AccountStore::GetInstance().UpdateAccountsTemp(
+               m_mediator.m_currentEpochNum, tx);
+}
+
+void Validator::CheckCreatedTransactions(const vector<Transaction>& txns,
+                                         vector<bool>& results) const
+{
+    // The sender checks only read the committed state, so they can all be
+    // done up front without changing the outcome
+    results.clear();
+    results.reserve(txns.size());
+    for (const auto& tx : txns)
+    {
+        results.push_back(CheckTransactionSender(tx));
+    }
+
+    AccountStore::GetInstance().UpdateAccountsTempBatch(
+        m_mediator.m_currentEpochNum, txns, results);
 }
 
 bool Validator::CheckCreatedTransactionFromLookup(const Transaction& tx)
@@ -18,6 +18,7 @@
 #define __VALIDATOR_H__
 
 #include <string>
+#include <vector>
 
 #include "libData/AccountData/Transaction.h"
 
@@ -32,10 +33,19 @@ public:
     /// Verifies the transaction w.r.t given pubKey and signature
     virtual bool VerifyTransaction(const Transaction& tran) const = 0;
 
+    /// Verifies the signatures of a batch of transactions at once
+    virtual bool VerifyTransactions(const std::vector<Transaction>& txns,
+                                    std::vector<bool>& results) const = 0;
+
     virtual void CleanVariables() = 0;
 
 #ifndef IS_LOOKUP_NODE
     virtual bool CheckCreatedTransaction(const Transaction& tx) const = 0;
+
+    /// Checks and applies a batch of transactions, in order, at once
+    virtual void
+    CheckCreatedTransactions(const std::vector<Transaction>& txns,
+                             std::vector<bool>& results) const = 0;
     virtual bool CheckCreatedTransactionFromLookup(const Transaction& tx) = 0;
 #endif // IS_LOOKUP_NODE
 };
@@ -47,15 +57,24 @@ class Validator : public ValidatorBase
     std::mutex m_mutexTxnNonceMap;
     std::unordered_map<Address, boost::multiprecision::uint256_t> m_txnNonceMap;
 
+#ifndef IS_LOOKUP_NODE
+    /// Checks the sender of a transaction against the committed state
+    bool CheckTransactionSender(const Transaction& tx) const;
+#endif // IS_LOOKUP_NODE
+
 public:
     Validator(Mediator& mediator);
     ~Validator();
     std::string name() const override { return "Validator"; }
     bool VerifyTransaction(const Transaction& tran) const override;
+    bool VerifyTransactions(const std::vector<Transaction>& txns,
+                            std::vector<bool>& results) const override;
     void CleanVariables() override;
 
 #ifndef IS_LOOKUP_NODE
     bool CheckCreatedTransaction(const Transaction& tx) const override;
+    void CheckCreatedTransactions(const std::vector<Transaction>& txns,
+                                  std::vector<bool>& results) const override;
     bool CheckCreatedTransactionFromLookup(const Transaction& tx) override;
 #endif // IS_LOOKUP_NODE
 
@@ -26,7 +26,6 @@
 #include "libData/AccountData/Address.h"
 #include "libNetwork/Whitelist.h"
 #include "libUtils/DataConversion.h"
-#include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
 
 using namespace std;
@@ -98,7 +97,6 @@ Zilliqa::Zilliqa(const std::pair<PrivKey, PubKey>& key, const Peer& peer,
     , m_lookup(m_mediator)
     , m_n(m_mediator, syncType, toRetrieveHistory)
     , m_cu(key, peer)
-    , m_msgQueue(MSGQUEUE_SIZE)
 #ifdef IS_LOOKUP_NODE
     , m_httpserver(SERVER_PORT)
     , m_server(m_mediator, m_httpserver)
@@ -107,22 +105,19 @@ Zilliqa::Zilliqa(const std::pair<PrivKey, PubKey>& key, const Peer& peer,
 {
     LOG_MARKER();
 
-    // Launch the thread that reads messages from the queue
-    auto funcCheckMsgQueue = [this]() mutable -> void {
-        pair<vector<unsigned char>, Peer>* message = NULL;
-        while (true)
-        {
-            while (m_msgQueue.pop(message))
-            {
-                // For now, we use a thread pool to handle this message
-                // Eventually processing will be single-threaded
-                m_queuePool.AddJob([this, message]() mutable -> void {
-                    ProcessMessage(message);
-                });
-            }
-        }
-    };
-    DetachedFunction(1, funcCheckMsgQueue);
+    // Each message type gets its own workers, so a flood of one type
+    // can't take the threads that another type's handlers need
+    const unsigned int laneThreads[] = {PEER_MSG_THREADS, DIRECTORY_MSG_THREADS,
+                                        NODE_MSG_THREADS, 1, LOOKUP_MSG_THREADS};
+    const char* laneNames[] = {"PeerPool", "DirectoryPool", "NodePool",
+                               "ConsensusUserPool", "LookupPool"};
+    for (unsigned int i = 0; i < m_lanes.size(); i++)
+    {
+        m_lanes[i].m_threads = max(laneThreads[i], 1u);
+        m_lanes[i].m_pending = 0;
+        m_lanes[i].m_pool.reset(
+            new ThreadPool(m_lanes[i].m_threads, laneNames[i]));
+    }
 
     m_validator = make_shared<Validator>(m_mediator);
     m_mediator.RegisterColleagues(&m_ds, &m_n, &m_lookup, m_validator.get());
@@ -191,24 +186,41 @@ Zilliqa::Zilliqa(const std::pair<PrivKey, PubKey>& key, const Peer& peer,
 #endif // IS_LOOKUP_NODE
 }
 
-Zilliqa::~Zilliqa()
+Zilliqa::~Zilliqa() {}
+
+void Zilliqa::Dispatch(pair<vector<unsigned char>, Peer>* message)
 {
-    pair<vector<unsigned char>, Peer>* message = NULL;
-    while (m_msgQueue.pop(message))
+    //LOG_MARKER();
+
+    if (message->first.size() < MessageOffset::BODY
+        || message->first.at(MessageOffset::TYPE) >= m_lanes.size())
     {
-        delete message;
+        // Let ProcessMessage report and free it right here
+        ProcessMessage(message);
+        return;
     }
+
+    MessageLane& lane = m_lanes[message->first.at(MessageOffset::TYPE)];
+
+    // This runs on a reactor thread, which must never wait for a worker.
+    // Every message is queued; once IsReady reports the backlog as full,
+    // P2PComm stops reading from the connection that sent it
+    lane.m_pending++;
+    lane.m_pool->AddJob([this, &lane, message]() mutable -> void {
+        ProcessMessage(message);
+        lane.m_pending--;
+    });
 }
 
-void Zilliqa::Dispatch(pair<vector<unsigned char>, Peer>* message)
+bool Zilliqa::IsReady(unsigned char msg_type) const
 {
-    //LOG_MARKER();
-
-    // Queue message
-    while (!m_msgQueue.push(message))
+    if (msg_type >= m_lanes.size())
     {
-        // Keep attempting to push until success
+        return true;
     }
+
+    const MessageLane& lane = m_lanes[msg_type];
+    return lane.m_pending < lane.m_threads + MSGQUEUE_SIZE;
 }
 
 vector<Peer> Zilliqa::RetrieveBroadcastList(unsigned char msg_type,
@@ -17,9 +17,13 @@
 #ifndef __ZILLIQA_H__
 #define __ZILLIQA_H__
 
+#include <array>
+#include <atomic>
 #include <jsonrpccpp/server/connectors/httpserver.h>
+#include <memory>
 #include <vector>
 
+#include "common/Messages.h"
 #include "libConsensus/ConsensusUser.h"
 #include "libDirectoryService/DirectoryService.h"
 #include "libLookup/Lookup.h"
@@ -45,8 +49,6 @@ class Zilliqa
     Node m_n;
     ConsensusUser
         m_cu; // Note: This is just a test class to demo Consensus usage
-    boost::lockfree::queue<std::pair<std::vector<unsigned char>, Peer>*>
-        m_msgQueue;
 
 #ifdef IS_LOOKUP_NODE
 
@@ -55,7 +57,16 @@ class Zilliqa
 
 #endif //IS_LOOK_UP_NODE
 
-    ThreadPool m_queuePool{MAXMESSAGE, "QueuePool"};
+    /// Worker pool of one message type, with a bound on the messages waiting for a worker.
+    struct MessageLane
+    {
+        std::unique_ptr<ThreadPool> m_pool;
+        unsigned int m_threads;
+        std::atomic<unsigned int> m_pending;
+    };
+
+    // One lane per MessageType, destroyed (and joined) before the handlers they call
+    std::array<MessageLane, MessageType::LOOKUP + 1> m_lanes;
 
     void ProcessMessage(std::pair<std::vector<unsigned char>, Peer>* message);
 
@@ -74,6 +85,9 @@ public:
     /// Forwards an incoming message for processing by the appropriate subclass.
     void Dispatch(std::pair<std::vector<unsigned char>, Peer>* message);
 
+    /// Returns false while the backlog of msg_type is full, so its senders should be paused.
+    bool IsReady(unsigned char msg_type) const;
+
     /// Returns a list of broadcast peers based on the specified message and instruction types.
     std::vector<Peer> RetrieveBroadcastList(unsigned char msg_type,
                                             unsigned char ins_type,
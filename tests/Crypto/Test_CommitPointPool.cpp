@@ -0,0 +1,78 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+#include "libCrypto/CommitPointPool.h"
+#include "libCrypto/MultiSig.h"
+#include "libUtils/Logger.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define BOOST_TEST_MODULE commitpointpooltest
+#include <boost/test/included/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(commitpointpooltest)
+
+BOOST_AUTO_TEST_CASE(test_pairs_are_fresh_and_consistent)
+{
+    INIT_STDOUT_LOGGER();
+
+    CommitPointPool& pool = CommitPointPool::GetInstance();
+
+    // Wait for the background thread to fill the pool
+    for (unsigned int i = 0; (i < 100) && (pool.Size() < COMMIT_POOL_SIZE);
+         i++)
+    {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    BOOST_CHECK_EQUAL(pool.Size(), COMMIT_POOL_SIZE);
+
+    // Take more than the pool holds, so some pairs are generated in place
+    vector<shared_ptr<CommitSecret>> secrets;
+    vector<shared_ptr<CommitPoint>> points;
+
+    for (unsigned int i = 0; i < 2 * COMMIT_POOL_SIZE + 2; i++)
+    {
+        shared_ptr<CommitSecret> secret;
+        shared_ptr<CommitPoint> point;
+        pool.Take(secret, point);
+
+        BOOST_REQUIRE(secret != nullptr && secret->Initialized());
+        BOOST_REQUIRE(point != nullptr && point->Initialized());
+        BOOST_CHECK(*point == CommitPoint(*secret));
+
+        for (unsigned int j = 0; j < secrets.size(); j++)
+        {
+            BOOST_CHECK(!(*secrets.at(j) == *secret));
+            BOOST_CHECK(secrets.at(j) != secret);
+            BOOST_CHECK(points.at(j) != point);
+        }
+
+        secrets.emplace_back(secret);
+        points.emplace_back(point);
+    }
+
+    // And it refills afterwards
+    for (unsigned int i = 0; (i < 100) && (pool.Size() < COMMIT_POOL_SIZE);
+         i++)
+    {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    BOOST_CHECK_EQUAL(pool.Size(), COMMIT_POOL_SIZE);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,7 @@
 
 #include "libCrypto/MultiSig.h"
 #include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
 
 #define BOOST_TEST_MODULE multisigtest
 #include <boost/test/included/unit_test.hpp>
@@ -216,4 +217,107 @@ BOOST_AUTO_TEST_CASE(test_serialization)
                         "Signature verification (wrong message) failed");
 }
 
+BOOST_AUTO_TEST_CASE(test_committee_aggregate)
+{
+    const unsigned int committee_size = 600;
+
+    vector<PubKey> committee;
+    for (unsigned int i = 0; i < committee_size; i++)
+    {
+        committee.emplace_back(Schnorr::GetInstance().GenKeyPair().second);
+    }
+
+    auto check = [&committee](const vector<bool>& bitmap) {
+        vector<PubKey> signers;
+        for (unsigned int i = 0; i < committee.size(); i++)
+        {
+            if (bitmap.at(i))
+            {
+                signers.emplace_back(committee.at(i));
+            }
+        }
+
+        shared_ptr<PubKey> expected = MultiSig::AggregatePubKeys(signers);
+        shared_ptr<PubKey> actual
+            = MultiSig::AggregatePubKeys(committee, bitmap);
+        BOOST_REQUIRE(expected != nullptr);
+        BOOST_REQUIRE(actual != nullptr);
+        BOOST_CHECK_MESSAGE(*expected == *actual,
+                            "Cached aggregate key mismatch for "
+                                << signers.size() << " signers");
+    };
+
+    // All present, 2/3 present at random, and only a few present
+    check(vector<bool>(committee_size, true));
+    for (unsigned int round = 0; round < 5; round++)
+    {
+        vector<bool> bitmap(committee_size, false);
+        for (unsigned int i = 0; i < committee_size; i++)
+        {
+            bitmap.at(i) = (rand() % 3) != 0;
+        }
+        check(bitmap);
+    }
+    vector<bool> few(committee_size, false);
+    few.at(7) = few.at(300) = true;
+    check(few);
+
+    // Invalid bitmaps
+    BOOST_CHECK(MultiSig::AggregatePubKeys(committee,
+                                           vector<bool>(committee_size, false))
+                == nullptr);
+    BOOST_CHECK(MultiSig::AggregatePubKeys(
+                    committee, vector<bool>(committee_size - 1, true))
+                == nullptr);
+
+    // A different committee must not reuse the cached sum
+    vector<PubKey> other(committee.begin(), committee.end() - 1);
+    other.emplace_back(Schnorr::GetInstance().GenKeyPair().second);
+    vector<bool> all(committee_size, true);
+    shared_ptr<PubKey> expected = MultiSig::AggregatePubKeys(other);
+    BOOST_CHECK(*MultiSig::AggregatePubKeys(other, all) == *expected);
+
+    // Compare against aggregating the signers from scratch, with the
+    // minimum 2/3 + 1 signers and with nearly everyone signing
+    for (unsigned int absent_every : {3, 100})
+    {
+        vector<bool> bitmap(committee_size, true);
+        for (unsigned int i = 0; i < committee_size; i += absent_every)
+        {
+            bitmap.at(i) = false;
+        }
+        vector<PubKey> signers;
+        for (unsigned int i = 0; i < committee_size; i++)
+        {
+            if (bitmap.at(i))
+            {
+                signers.emplace_back(committee.at(i));
+            }
+        }
+
+        const unsigned int iterations = 50;
+        auto t = r_timer_start();
+        for (unsigned int i = 0; i < iterations; i++)
+        {
+            MultiSig::AggregatePubKeys(signers);
+        }
+        double scratch_usec = r_timer_end(t);
+
+        t = r_timer_start();
+        for (unsigned int i = 0; i < iterations; i++)
+        {
+            MultiSig::AggregatePubKeys(committee, bitmap);
+        }
+        double cached_usec = r_timer_end(t);
+
+        LOG_GENERAL(INFO,
+                    "Aggregate key (usec) for " << signers.size() << " of "
+                                                << committee_size
+                                                << " keys: from scratch = "
+                                                << scratch_usec / iterations
+                                                << " cached = "
+                                                << cached_usec / iterations);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include "libCrypto/PubKeyCache.h"
+#include "libCrypto/Schnorr.h"
+#include "libCrypto/Sha2.h"
+#include "libUtils/Logger.h"
+#include <thread>
+#include <vector>
+
+#define BOOST_TEST_MODULE pubkeycachetest
+#include <boost/test/included/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(pubkeycachetest)
+
+BOOST_AUTO_TEST_CASE(test_decode_and_address)
+{
+    INIT_STDOUT_LOGGER();
+
+    PubKeyCache& cache = PubKeyCache::GetInstance();
+    const Curve& curve = Schnorr::GetInstance().GetCurve();
+
+    PubKey pubkey = Schnorr::GetInstance().GenKeyPair().second;
+    vector<unsigned char> bytes;
+    pubkey.Serialize(bytes, 0);
+
+    PubKeyCache::Stats before = cache.GetStats();
+
+    auto point = cache.GetPoint(bytes, 0);
+    BOOST_REQUIRE(point != nullptr);
+    BOOST_CHECK(EC_POINT_cmp(curve.m_group.get(), point.get(),
+                             pubkey.m_P.get(), Schnorr::GetBNCtx())
+                == 0);
+
+    // Same bytes again must come from the cache
+    BOOST_CHECK(cache.GetPoint(bytes, 0) == point);
+
+    SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+    sha2.Update(bytes);
+    const vector<unsigned char>& output = sha2.Finalize();
+    Address expected;
+    copy(output.end() - ACC_ADDR_SIZE, output.end(),
+         expected.asArray().begin());
+    BOOST_CHECK(cache.GetAddress(bytes, 0) == expected);
+
+    PubKeyCache::Stats after = cache.GetStats();
+    BOOST_CHECK_EQUAL(after.m_misses - before.m_misses, 1);
+    BOOST_CHECK_EQUAL(after.m_hits - before.m_hits, 2);
+
+    // Deserialized keys get their own copy of the point
+    PubKey copy1(bytes, 0);
+    PubKey copy2(bytes, 0);
+    BOOST_CHECK(copy1 == pubkey);
+    BOOST_CHECK(copy1.m_P.get() != copy2.m_P.get());
+    BOOST_CHECK(copy1.m_P.get() != point.get());
+}
+
+BOOST_AUTO_TEST_CASE(test_address_without_decoding)
+{
+    INIT_STDOUT_LOGGER();
+
+    PubKeyCache& cache = PubKeyCache::GetInstance();
+
+    vector<unsigned char> bytes;
+    Schnorr::GetInstance().GenKeyPair().second.Serialize(bytes, 0);
+
+    // A deserialized key keeps its wire bytes and hands them back unchanged
+    PubKey pubkey(bytes, 0);
+    BOOST_REQUIRE(pubkey.m_hasCompressed);
+    BOOST_CHECK(equal(bytes.begin(), bytes.end(), pubkey.m_compressed.begin()));
+
+    PubKey copied(pubkey);
+    vector<unsigned char> reserialized;
+    copied.Serialize(reserialized, 0);
+    BOOST_CHECK(reserialized == bytes);
+
+    // The address comes from the cache entry made by the deserialization
+    PubKeyCache::Stats before = cache.GetStats();
+    BOOST_CHECK(cache.GetAddress(pubkey.m_compressed)
+                == cache.GetAddress(bytes, 0));
+    PubKeyCache::Stats after = cache.GetStats();
+    BOOST_CHECK_EQUAL(after.m_misses - before.m_misses, 0);
+
+    // A new key only gets hashed; its point is decoded once it is asked for
+    vector<unsigned char> other;
+    Schnorr::GetInstance().GenKeyPair().second.Serialize(other, 0);
+
+    before = cache.GetStats();
+    cache.GetAddress(other, 0);
+    cache.GetAddress(other, 0);
+    after = cache.GetStats();
+    BOOST_CHECK_EQUAL(after.m_misses - before.m_misses, 1);
+    BOOST_CHECK_EQUAL(after.m_hits - before.m_hits, 1);
+
+    BOOST_CHECK(cache.GetPoint(other, 0) != nullptr);
+    BOOST_CHECK(cache.GetPoint(other, 0) != nullptr);
+    BOOST_CHECK_EQUAL(cache.GetStats().m_misses - after.m_misses, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_key)
+{
+    PubKeyCache& cache = PubKeyCache::GetInstance();
+
+    // x = 0 is not on secp256k1
+    vector<unsigned char> bytes(PUB_KEY_SIZE, 0);
+    bytes[0] = 0x02;
+    BOOST_CHECK(cache.GetPoint(bytes, 0) == nullptr);
+
+    // Truncated stream
+    vector<unsigned char> truncated(PUB_KEY_SIZE - 1, 0x02);
+    BOOST_CHECK(cache.GetPoint(truncated, 0) == nullptr);
+    BOOST_CHECK(cache.GetAddress(truncated, 0) == Address());
+}
+
+BOOST_AUTO_TEST_CASE(test_bounded_size)
+{
+    PubKeyCache& cache = PubKeyCache::GetInstance();
+
+    vector<vector<unsigned char>> keys(2 * PUBKEY_CACHE_SIZE);
+    for (auto& key : keys)
+    {
+        Schnorr::GetInstance().GenKeyPair().second.Serialize(key, 0);
+    }
+
+    vector<thread> threads;
+    const unsigned int num_threads = 4;
+    for (unsigned int t = 0; t < num_threads; t++)
+    {
+        threads.emplace_back([&cache, &keys, t]() {
+            for (unsigned int i = t; i < keys.size(); i += num_threads)
+            {
+                BOOST_CHECK(cache.GetPoint(keys.at(i), 0) != nullptr);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    PubKeyCache::Stats stats = cache.GetStats();
+    BOOST_CHECK(stats.m_entries <= PUBKEY_CACHE_SIZE);
+    BOOST_CHECK(stats.m_evictions >= PUBKEY_CACHE_SIZE);
+
+    LOG_GENERAL(INFO,
+                "Entries: " << stats.m_entries << " Memory (bytes): "
+                            << stats.m_memoryBytes
+                            << " Hits: " << stats.m_hits
+                            << " Misses: " << stats.m_misses);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
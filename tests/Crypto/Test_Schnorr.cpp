@@ -17,7 +17,9 @@
 #include "libCrypto/Schnorr.h"
 #include "libUtils/Logger.h"
 #include "libUtils/TimeUtils.h"
+#include <atomic>
 #include <cstring>
+#include <thread>
 
 #define BOOST_TEST_MODULE schnorrtest
 #include <boost/test/included/unit_test.hpp>
@@ -268,4 +270,151 @@ BOOST_AUTO_TEST_CASE(test_serialization)
                         "Signature serialization check #2 failed");
 }
 
+BOOST_AUTO_TEST_CASE(test_concurrent_verify)
+{
+    Schnorr& schnorr = Schnorr::GetInstance();
+
+    const unsigned int num_signatures = 512;
+    const unsigned int message_size = 1024;
+
+    vector<pair<PrivKey, PubKey>> keypairs;
+    vector<vector<unsigned char>> messages;
+    vector<Signature> signatures(num_signatures);
+
+    for (unsigned int i = 0; i < num_signatures; i++)
+    {
+        keypairs.emplace_back(schnorr.GenKeyPair());
+        messages.emplace_back(message_size);
+        generate(messages.back().begin(), messages.back().end(), std::rand);
+        BOOST_REQUIRE(schnorr.Sign(messages.at(i), keypairs.at(i).first,
+                                   keypairs.at(i).second, signatures.at(i)));
+    }
+
+    const unsigned int max_threads
+        = max(thread::hardware_concurrency(), (unsigned int)1);
+
+    // Verification throughput should grow with the number of threads
+    for (unsigned int num_threads = 1; num_threads <= max_threads;
+         num_threads *= 2)
+    {
+        atomic<unsigned int> next(0);
+        atomic<unsigned int> verified(0);
+
+        auto t = r_timer_start();
+
+        vector<thread> threads;
+        for (unsigned int j = 0; j < num_threads; j++)
+        {
+            threads.emplace_back([&]() {
+                unsigned int i;
+                while ((i = next++) < num_signatures)
+                {
+                    // Alternate a correct and a wrong key, so both paths run concurrently
+                    if (schnorr.Verify(messages.at(i), signatures.at(i),
+                                       keypairs.at(i).second)
+                        && !schnorr.Verify(
+                               messages.at(i), signatures.at(i),
+                               keypairs.at((i + 1) % num_signatures).second))
+                    {
+                        verified++;
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        double usec = r_timer_end(t);
+
+        BOOST_CHECK_MESSAGE(verified == num_signatures,
+                            "Concurrent verification failed with "
+                                << num_threads << " threads");
+        LOG_GENERAL(INFO,
+                    "Threads = " << num_threads << " Verify/sec = "
+                                 << (2 * num_signatures * 1000000.0 / usec));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_batch_verify)
+{
+    Schnorr& schnorr = Schnorr::GetInstance();
+
+    const unsigned int num_signatures = 1024;
+    const unsigned int message_size = 256;
+
+    vector<pair<PrivKey, PubKey>> keypairs;
+    vector<vector<unsigned char>> messages;
+    vector<Signature> signatures(num_signatures);
+
+    for (unsigned int i = 0; i < num_signatures; i++)
+    {
+        keypairs.emplace_back(schnorr.GenKeyPair());
+        messages.emplace_back(message_size);
+        generate(messages.back().begin(), messages.back().end(), std::rand);
+        BOOST_REQUIRE(schnorr.Sign(messages.at(i), keypairs.at(i).first,
+                                   keypairs.at(i).second, signatures.at(i)));
+    }
+
+    vector<SignedMessageRef> batch;
+    for (unsigned int i = 0; i < num_signatures; i++)
+    {
+        batch.emplace_back(messages.at(i), signatures.at(i),
+                           keypairs.at(i).second);
+    }
+
+    auto t = r_timer_start();
+    for (unsigned int i = 0; i < num_signatures; i++)
+    {
+        BOOST_CHECK(schnorr.Verify(messages.at(i), signatures.at(i),
+                                   keypairs.at(i).second));
+    }
+    double serial_usec = r_timer_end(t);
+
+    vector<bool> results;
+    t = r_timer_start();
+    BOOST_CHECK_MESSAGE(schnorr.BatchVerify(batch, results),
+                        "Batch verification of valid signatures failed");
+    double batch_usec = r_timer_end(t);
+
+    BOOST_CHECK_MESSAGE(
+        count(results.begin(), results.end(), true) == num_signatures,
+        "Batch verification rejected a valid signature");
+    LOG_GENERAL(INFO,
+                "Signatures = " << num_signatures << " Serial usec = "
+                                << serial_usec
+                                << " Batch usec = " << batch_usec);
+
+    // Corrupt a few entries and check that exactly those are reported
+    const vector<unsigned int> bad_entries = {0, 17, 500, num_signatures - 1};
+    for (auto i : bad_entries)
+    {
+        messages.at(i).at(0) ^= 0xFF;
+    }
+
+    BOOST_CHECK_MESSAGE(!schnorr.BatchVerify(batch, results),
+                        "Batch verification accepted a bad signature");
+    for (unsigned int i = 0; i < num_signatures; i++)
+    {
+        bool expected = find(bad_entries.begin(), bad_entries.end(), i)
+            == bad_entries.end();
+        BOOST_CHECK_MESSAGE(results.at(i) == expected,
+                            "Wrong batch verification result for entry "
+                                << i);
+    }
+
+    // Empty and single-entry batches
+    vector<SignedMessageRef> empty_batch;
+    BOOST_CHECK(schnorr.BatchVerify(empty_batch, results));
+    BOOST_CHECK(results.empty());
+
+    vector<SignedMessageRef> single_batch;
+    single_batch.emplace_back(messages.at(1), signatures.at(1),
+                              keypairs.at(1).second);
+    BOOST_CHECK(schnorr.BatchVerify(single_batch, results));
+    BOOST_CHECK(results.size() == 1 && results.at(0));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
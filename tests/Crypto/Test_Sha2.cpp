@@ -17,6 +17,7 @@
 **/
 
 #include "libCrypto/Sha2.h"
+#include "libCrypto/Sha2Batch.h"
 #include "libUtils/DataConversion.h"
 #include <iomanip>
 
@@ -92,4 +93,60 @@ BOOST_AUTO_TEST_CASE(SHA256_check_896bitsx3_updatewithoffset)
     BOOST_CHECK_EQUAL(is_equal, true);
 }
 
+BOOST_AUTO_TEST_CASE(SHA256_check_empty_into_digest)
+{
+    SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+    sha2.Update(vector<unsigned char>());
+    SHA2<HASH_TYPE::HASH_VARIANT_256>::Digest output;
+    sha2.Finalize(output);
+
+    std::vector<unsigned char> expected = DataConversion::HexStrToUint8Vec(
+        "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855");
+    bool is_equal
+        = std::equal(expected.begin(), expected.end(), output.begin());
+    BOOST_CHECK_EQUAL(is_equal, true);
+}
+
+BOOST_AUTO_TEST_CASE(SHA256_check_batch)
+{
+    // Lengths around the padding boundaries, in mixed order
+    vector<vector<unsigned char>> messages;
+    for (unsigned int size = 0; size < 200; size++)
+    {
+        unsigned int length = (size * 37) % 200;
+        vector<unsigned char> message(length);
+        for (unsigned int i = 0; i < length; i++)
+        {
+            message.at(i) = (unsigned char)(i * 7 + size);
+        }
+        messages.emplace_back(message);
+    }
+
+    vector<ByteSpan> inputs;
+    vector<SHA256Batch::Digest> expected(messages.size());
+    for (unsigned int i = 0; i < messages.size(); i++)
+    {
+        inputs.emplace_back(messages.at(i));
+
+        SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+        sha2.Update(messages.at(i));
+        vector<unsigned char> output = sha2.Finalize();
+        copy(output.begin(), output.end(), expected.at(i).begin());
+    }
+
+    vector<SHA256Batch::Digest> digests;
+    SHA256Batch::Hash(inputs, digests);
+    BOOST_CHECK(digests == expected);
+
+    digests.clear();
+    if (SHA256Batch::HashMultiBuffer(inputs, digests))
+    {
+        BOOST_CHECK(digests == expected);
+    }
+    else
+    {
+        BOOST_TEST_MESSAGE("No AVX2, multi-buffer kernel not tested");
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
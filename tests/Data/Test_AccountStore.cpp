@@ -16,6 +16,7 @@
 
 #include <array>
 #include <string>
+#include <vector>
 
 #define BOOST_TEST_MODULE accountstoretest
 #define BOOST_TEST_DYN_LINK
@@ -25,6 +26,7 @@
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/AccountStore.h"
 #include "libData/AccountData/Address.h"
+#include "libPersistence/ContractStorage.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/Logger.h"
 
@@ -365,4 +367,181 @@ BOOST_AUTO_TEST_CASE(commitAndRollback)
     //     BOOST_CHECK_MESSAGE(root1 != root2, "IncreaseNonce didn't change root!");
 }
 
+BOOST_AUTO_TEST_CASE(batchMatchesSequential)
+{
+    INIT_STDOUT_LOGGER();
+
+    LOG_MARKER();
+
+    AccountStore::GetInstance().Init();
+
+    // A handful of senders so that transfers both overlap and stay disjoint
+    vector<KeyPair> senders;
+    vector<Address> addresses;
+    for (unsigned int i = 0; i < 16; i++)
+    {
+        senders.emplace_back(Schnorr::GetInstance().GenKeyPair());
+        addresses.emplace_back(
+            Account::GetAddressFromPublicKey(senders.back().second));
+        AccountStore::GetInstance().AddAccount(addresses.back(),
+                                               {100 + 37 * i, 0});
+    }
+
+    // A contract, and a sender that only ever pays it: the rejected
+    // transfers must not pull that sender into the state delta
+    Address contractAddr;
+    contractAddr.asArray().at(0) = 0xc0;
+    Account contract(0, 0);
+    contract.SetCode({'c', 'o', 'd', 'e'});
+    AccountStore::GetInstance().AddAccount(contractAddr, contract);
+
+    KeyPair contractPayer = Schnorr::GetInstance().GenKeyPair();
+    AccountStore::GetInstance().AddAccount(
+        Account::GetAddressFromPublicKey(contractPayer.second), {1000, 0});
+
+    vector<Transaction> txns;
+    for (unsigned int i = 0; i < 400; i++)
+    {
+        unsigned int sender = (i * 7) % senders.size();
+        if (i % 17 == 0)
+        {
+            txns.emplace_back(1, 0, contractAddr, contractPayer, 1, 1, 1);
+            continue;
+        }
+        if (i % 97 == 50)
+        {
+            // Contract creation, rejected for its gas limit, that splits
+            // the transfers into separate runs
+            txns.emplace_back(1, 0, NullAddress, senders.at(sender), 0, 1, 1,
+                              vector<unsigned char>{'c'});
+            continue;
+        }
+
+        Address toAddr = addresses.at((i % 3 == 0) ? (sender ^ 1)
+                                                   : (i * 5) % senders.size());
+        if (i % 11 == 0)
+        {
+            // Recipient that does not exist yet
+            toAddr.asArray().at(0) ^= 0xff;
+        }
+        uint256_t gasLimit = (i % 13 == 0) ? 0 : 1;
+        txns.emplace_back(1, 0, toAddr, senders.at(sender), i % 50, 1,
+                          gasLimit);
+    }
+
+    vector<bool> sequential;
+    for (const auto& tx : txns)
+    {
+        sequential.push_back(
+            AccountStore::GetInstance().UpdateAccountsTemp(1, tx));
+    }
+    AccountStore::GetInstance().SerializeDelta();
+    vector<unsigned char> sequentialDelta;
+    AccountStore::GetInstance().GetSerializedDelta(sequentialDelta);
+    AccountStore::GetInstance().InitTemp();
+
+    vector<bool> batch(txns.size(), true);
+    AccountStore::GetInstance().UpdateAccountsTempBatch(1, txns, batch);
+    AccountStore::GetInstance().SerializeDelta();
+    vector<unsigned char> batchDelta;
+    AccountStore::GetInstance().GetSerializedDelta(batchDelta);
+    AccountStore::GetInstance().InitTemp();
+
+    BOOST_CHECK_MESSAGE(batch == sequential,
+                        "Batch results differ from sequential execution!");
+    BOOST_CHECK_MESSAGE(batchDelta == sequentialDelta,
+                        "Batch state delta differs from sequential execution!");
+}
+
+BOOST_AUTO_TEST_CASE(noDeltaAfterSerialize)
+{
+    INIT_STDOUT_LOGGER();
+
+    LOG_MARKER();
+
+    AccountStore::GetInstance().Init();
+
+    Address address;
+    address.asArray().at(0) = 0x5e;
+    AccountStore::GetInstance().AddAccountTemp(address, {5, 0});
+    AccountStore::GetInstance().SerializeDelta();
+    vector<unsigned char> delta;
+    AccountStore::GetInstance().GetSerializedDelta(delta);
+
+    // The block's delta is fixed now, so a late one must not reach CommitTemp
+    BOOST_CHECK_MESSAGE(
+        AccountStore::GetInstance().DeserializeDeltaTemp(delta, 0) != 0,
+        "Delta accepted after SerializeDelta!");
+
+    AccountStore::GetInstance().InitTemp();
+    BOOST_CHECK_MESSAGE(
+        AccountStore::GetInstance().DeserializeDeltaTemp(delta, 0) == 0,
+        "Delta rejected after InitTemp!");
+
+    AccountStore::GetInstance().SerializeDelta();
+    AccountStore::GetInstance().CommitTemp();
+    BOOST_CHECK_MESSAGE(
+        AccountStore::GetInstance().GetBalance(address) == 5,
+        "CommitTemp did not apply the serialized delta!");
+}
+
+BOOST_AUTO_TEST_CASE(flushOnlyDirtyAccounts)
+{
+    INIT_STDOUT_LOGGER();
+
+    LOG_MARKER();
+
+    AccountStore::GetInstance().Init();
+
+    Address payerAddr;
+    payerAddr.asArray().at(0) = 0xd1;
+    AccountStore::GetInstance().AddAccount(payerAddr, {9, 0});
+
+    Address contractAddr;
+    contractAddr.asArray().at(0) = 0xd2;
+    const vector<unsigned char> code = {'o', 'n', 'c', 'e'};
+    Account contract(0, 0);
+    contract.SetCode(code);
+    AccountStore::GetInstance().AddAccount(contractAddr, contract);
+
+    Account* flushed = AccountStore::GetInstance().GetAccount(contractAddr);
+    BOOST_REQUIRE(flushed != nullptr);
+    BOOST_CHECK_MESSAGE(flushed->IsDirty(Account::DIRTY_CODE),
+                        "New code not marked dirty!");
+
+    AccountStore::GetInstance().MoveUpdatesToDisk();
+    BOOST_CHECK_MESSAGE(
+        ContractStorage::GetContractStorage().GetContractCode(contractAddr)
+            == code,
+        "Dirty code not written on flush!");
+    BOOST_CHECK_MESSAGE(!flushed->IsDirty(), "Flush left the account dirty!");
+
+    // Code already on disk is not written again, nor are clean accounts
+    const vector<unsigned char> marker = {'x'};
+    ContractStorage::GetContractStorage().PutContractCode(contractAddr, marker);
+    AccountStore::GetInstance().IncreaseBalance(payerAddr, 1);
+    BOOST_CHECK_MESSAGE(
+        AccountStore::GetInstance().GetAccount(payerAddr)->IsDirty(
+            Account::DIRTY_BALANCE_NONCE),
+        "Balance change not marked dirty!");
+
+    AccountStore::GetInstance().MoveUpdatesToDisk();
+    BOOST_CHECK_MESSAGE(
+        ContractStorage::GetContractStorage().GetContractCode(contractAddr)
+            == marker,
+        "Clean account's code written again!");
+    BOOST_CHECK_MESSAGE(
+        !AccountStore::GetInstance().GetAccount(payerAddr)->IsDirty(),
+        "Flush left the account dirty!");
+
+    // Commit clears every part at once
+    Account account(1, 0);
+    account.SetCode(code);
+    account.IncreaseNonce();
+    BOOST_CHECK(account.IsDirty(Account::DIRTY_BALANCE_NONCE));
+    BOOST_CHECK(account.IsDirty(Account::DIRTY_CODE));
+    account.Commit();
+    BOOST_CHECK_MESSAGE(!account.IsDirty(), "Commit left the account dirty!");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
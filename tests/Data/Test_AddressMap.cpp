@@ -0,0 +1,176 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+#include <map>
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_MODULE addressmaptest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libData/AccountData/Account.h"
+#include "libData/AccountData/AddressMap.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace
+{
+    Address RandomAddress(mt19937_64& rng)
+    {
+        Address address;
+        for (auto& b : address.asArray())
+        {
+            b = rng() & 0xff;
+        }
+        return address;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(addressmaptest)
+
+BOOST_AUTO_TEST_CASE(matchesStdMap)
+{
+    INIT_STDOUT_LOGGER();
+
+    LOG_MARKER();
+
+    mt19937_64 rng(1);
+    vector<Address> keys;
+    for (unsigned int i = 0; i < 500; i++)
+    {
+        keys.emplace_back(RandomAddress(rng));
+    }
+    // Keys that share their first 8 bytes
+    for (unsigned int i = 0; i < 50; i++)
+    {
+        Address address = keys.front();
+        address.asArray().back() = i;
+        keys.emplace_back(address);
+    }
+
+    AddressMap<unsigned int> flat;
+    map<Address, unsigned int> reference;
+
+    for (unsigned int i = 0; i < 20000; i++)
+    {
+        const Address& key = keys.at(rng() % keys.size());
+        switch (rng() % 4)
+        {
+        case 0:
+            BOOST_CHECK(flat.insert(make_pair(key, i)).second
+                        == reference.insert(make_pair(key, i)).second);
+            break;
+        case 1:
+            flat[key] = i;
+            reference[key] = i;
+            break;
+        case 2:
+            BOOST_CHECK_EQUAL(flat.erase(key), reference.erase(key));
+            break;
+        default:
+        {
+            auto it = flat.find(key);
+            auto ref = reference.find(key);
+            BOOST_REQUIRE((it == flat.end()) == (ref == reference.end()));
+            if (ref != reference.end())
+            {
+                BOOST_CHECK_EQUAL(it->second, ref->second);
+                flat.erase(it);
+                reference.erase(ref);
+            }
+        }
+        }
+        BOOST_REQUIRE_EQUAL(flat.size(), reference.size());
+    }
+
+    map<Address, unsigned int> iterated(flat.begin(), flat.end());
+    BOOST_CHECK(iterated == reference);
+
+    flat.clear();
+    BOOST_CHECK(flat.empty() && flat.begin() == flat.end());
+}
+
+BOOST_AUTO_TEST_CASE(valuesDoNotMove)
+{
+    INIT_STDOUT_LOGGER();
+
+    LOG_MARKER();
+
+    mt19937_64 rng(2);
+    AddressMap<Account> accounts;
+    vector<pair<Address, Account*>> held;
+
+    for (unsigned int i = 0; i < 5000; i++)
+    {
+        Address address = RandomAddress(rng);
+        auto it = accounts.emplace(piecewise_construct,
+                                   forward_as_tuple(address),
+                                   forward_as_tuple(i, 0));
+        held.emplace_back(address, &it.first->second);
+    }
+
+    for (unsigned int i = 0; i < held.size(); i++)
+    {
+        BOOST_REQUIRE(&accounts.find(held.at(i).first)->second
+                      == held.at(i).second);
+        BOOST_REQUIRE(held.at(i).second->GetBalance() == i);
+    }
+}
+
+namespace
+{
+    struct Counted
+    {
+        static unsigned int constructed;
+
+        explicit Counted(unsigned int value)
+            : m_value(value)
+        {
+            constructed++;
+        }
+
+        unsigned int m_value;
+    };
+
+    unsigned int Counted::constructed = 0;
+}
+
+BOOST_AUTO_TEST_CASE(emplaceHitBuildsNothing)
+{
+    INIT_STDOUT_LOGGER();
+
+    LOG_MARKER();
+
+    mt19937_64 rng(4);
+    const Address key = RandomAddress(rng);
+    AddressMap<Counted> counted;
+
+    BOOST_CHECK(counted.emplace(piecewise_construct, forward_as_tuple(key),
+                                forward_as_tuple(1))
+                    .second);
+    BOOST_CHECK_EQUAL(Counted::constructed, 1);
+
+    // A hit finds the entry by key alone, whichever form the key comes in
+    BOOST_CHECK(!counted.emplace(piecewise_construct, forward_as_tuple(key),
+                                 forward_as_tuple(2))
+                     .second);
+    BOOST_CHECK(!counted.emplace(key, Counted(3)).second);
+    BOOST_CHECK_EQUAL(Counted::constructed, 2);
+    BOOST_CHECK_EQUAL(counted.find(key)->second.m_value, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
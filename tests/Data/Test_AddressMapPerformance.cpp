@@ -0,0 +1,107 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#define BOOST_TEST_MODULE addressmapperformance
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libData/AccountData/Account.h"
+#include "libData/AccountData/AddressMap.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace
+{
+    Address RandomAddress(mt19937_64& rng)
+    {
+        Address address;
+        for (auto& b : address.asArray())
+        {
+            b = rng() & 0xff;
+        }
+        return address;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(addressmapperformance)
+
+template<class MAP>
+void TimeMap(const string& name, const vector<Address>& keys,
+             const vector<Address>& lookups)
+{
+    MAP accounts;
+
+    auto start = chrono::high_resolution_clock::now();
+    for (const auto& key : keys)
+    {
+        accounts.emplace(piecewise_construct, forward_as_tuple(key),
+                         forward_as_tuple(1, 0));
+    }
+    auto inserted = chrono::high_resolution_clock::now();
+
+    unsigned int found = 0;
+    for (const auto& key : lookups)
+    {
+        found += accounts.find(key) != accounts.end();
+    }
+    auto end = chrono::high_resolution_clock::now();
+
+    BOOST_CHECK_EQUAL(found, lookups.size() / 2);
+
+    typedef chrono::duration<double, milli> ms;
+    double insertRate = keys.size() / ms(inserted - start).count();
+    double lookupRate = lookups.size() / ms(end - inserted).count();
+
+    LOG_GENERAL(INFO,
+                name << ": " << insertRate << " inserts/ms, " << lookupRate
+                     << " lookups/ms");
+}
+
+BOOST_AUTO_TEST_CASE(throughput)
+{
+    INIT_STDOUT_LOGGER();
+
+    LOG_MARKER();
+
+    mt19937_64 rng(3);
+    vector<Address> keys;
+    for (unsigned int i = 0; i < 200000; i++)
+    {
+        keys.emplace_back(RandomAddress(rng));
+    }
+
+    // Half hits, half misses, in random order
+    vector<Address> lookups;
+    for (unsigned int i = 0; i < keys.size(); i++)
+    {
+        lookups.emplace_back((i % 2) ? keys.at(rng() % keys.size())
+                                     : RandomAddress(rng));
+    }
+
+    TimeMap<AddressMap<Account>>("AddressMap", keys, lookups);
+    TimeMap<map<Address, Account>>("std::map", keys, lookups);
+    TimeMap<unordered_map<Address, Account>>("std::unordered_map", keys,
+                                             lookups);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "libNetwork/BroadcastHashStore.h"
+
+#define BOOST_TEST_MODULE broadcasthashstore
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+static vector<unsigned char> MakeHash(unsigned int seed)
+{
+    vector<unsigned char> hash(BroadcastHashStore::HASH_SIZE);
+    for (unsigned int i = 0; i < hash.size(); i++)
+    {
+        hash[i] = (unsigned char)((seed * 131 + i * 7 + (seed >> (i % 24)))
+                                  & 0xFF);
+    }
+    return hash;
+}
+
+BOOST_AUTO_TEST_SUITE(broadcasthashstore)
+
+BOOST_AUTO_TEST_CASE(test_insert_and_duplicate)
+{
+    for (bool bloom : {false, true})
+    {
+        BroadcastHashStore store(chrono::seconds(60), 11, bloom);
+
+        vector<unsigned char> hash = MakeHash(1);
+        BOOST_CHECK_MESSAGE(!store.Contains(hash), "New hash already present");
+        BOOST_CHECK_MESSAGE(store.Insert(hash), "First insert rejected");
+        BOOST_CHECK_MESSAGE(store.Contains(hash), "Inserted hash not found");
+        BOOST_CHECK_MESSAGE(!store.Insert(hash), "Duplicate insert accepted");
+        BOOST_CHECK_MESSAGE(!store.Contains(MakeHash(2)),
+                            "Unrelated hash reported present");
+        BOOST_CHECK_EQUAL(store.Size(), 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_rejects_malformed_hash)
+{
+    BroadcastHashStore store(chrono::seconds(60), 11, true);
+
+    vector<unsigned char> shortHash(BroadcastHashStore::HASH_SIZE - 1, 0x01);
+    BOOST_CHECK_MESSAGE(!store.Insert(shortHash), "Short hash accepted");
+    BOOST_CHECK_MESSAGE(!store.Contains(shortHash), "Short hash found");
+    BOOST_CHECK_EQUAL(store.Size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_expiry)
+{
+    BroadcastHashStore store(chrono::milliseconds(50), 3, true);
+
+    vector<unsigned char> hash = MakeHash(3);
+    BOOST_CHECK(store.Insert(hash));
+    BOOST_CHECK(store.Contains(hash));
+
+    // Lifetime is at most three ticks
+    this_thread::sleep_for(chrono::milliseconds(250));
+
+    BOOST_CHECK_MESSAGE(!store.Contains(hash), "Hash did not expire");
+    BOOST_CHECK_MESSAGE(store.Insert(hash), "Expired hash not re-accepted");
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_insert)
+{
+    const unsigned int NUM_THREADS = 8;
+    const unsigned int NUM_HASHES = 2000;
+
+    BroadcastHashStore store(chrono::seconds(60), 11, true);
+    atomic<unsigned int> accepted(0);
+
+    // Every thread offers the same hashes, each must be accepted exactly once
+    vector<thread> threads;
+    for (unsigned int t = 0; t < NUM_THREADS; t++)
+    {
+        threads.emplace_back([&store, &accepted, NUM_HASHES]() {
+            for (unsigned int i = 0; i < NUM_HASHES; i++)
+            {
+                if (store.Insert(MakeHash(i)))
+                {
+                    accepted++;
+                }
+            }
+        });
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    BOOST_CHECK_EQUAL(accepted.load(), NUM_HASHES);
+    BOOST_CHECK_EQUAL(store.Size(), NUM_HASHES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
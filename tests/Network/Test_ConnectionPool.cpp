@@ -0,0 +1,145 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "libNetwork/ConnectionPool.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE connectionpool
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+static bool WriteBytes(int cli_sock, const vector<unsigned char>& bytes)
+{
+    return send(cli_sock, bytes.data(), bytes.size(), MSG_NOSIGNAL)
+        == (ssize_t)bytes.size();
+}
+
+static vector<unsigned char> ReadBytes(int cli_sock, size_t len)
+{
+    vector<unsigned char> bytes(len);
+    size_t read_length = 0;
+
+    while (read_length < len)
+    {
+        ssize_t n = recv(cli_sock, bytes.data() + read_length,
+                         len - read_length, 0);
+        if (n <= 0)
+        {
+            break;
+        }
+        read_length += n;
+    }
+
+    bytes.resize(read_length);
+    return bytes;
+}
+
+BOOST_AUTO_TEST_SUITE(connectionpool)
+
+BOOST_AUTO_TEST_CASE(test_reuse_connection)
+{
+    INIT_STDOUT_LOGGER();
+
+    int serv_sock = socket(AF_INET, SOCK_STREAM, 0);
+    BOOST_REQUIRE(serv_sock >= 0);
+
+    struct sockaddr_in serv_addr;
+    memset(&serv_addr, 0, sizeof(struct sockaddr_in));
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    serv_addr.sin_port = 0;
+    socklen_t addr_size = sizeof(struct sockaddr_in);
+
+    BOOST_REQUIRE(bind(serv_sock, (struct sockaddr*)&serv_addr, addr_size)
+                  == 0);
+    BOOST_REQUIRE(listen(serv_sock, 4) == 0);
+    getsockname(serv_sock, (struct sockaddr*)&serv_addr, &addr_size);
+
+    Peer peer(serv_addr.sin_addr.s_addr, ntohs(serv_addr.sin_port));
+    ConnectionPool& pool = ConnectionPool::GetInstance();
+
+    const vector<unsigned char> first = {'H', 'e', 'l', 'l', 'o'};
+    const vector<unsigned char> second = {'W', 'o', 'r', 'l', 'd'};
+
+    BOOST_CHECK_MESSAGE(pool.Send(peer,
+                                  [&first](int cli_sock) {
+                                      return WriteBytes(cli_sock, first);
+                                  }),
+                        "First send should succeed");
+    BOOST_CHECK_MESSAGE(pool.Send(peer,
+                                  [&second](int cli_sock) {
+                                      return WriteBytes(cli_sock, second);
+                                  }),
+                        "Second send should succeed");
+    BOOST_CHECK_MESSAGE(pool.Size() == 1,
+                        "Both messages should share one pooled connection");
+
+    // Both frames must arrive back to back on the single accepted connection
+    int conn_sock = accept(serv_sock, nullptr, nullptr);
+    BOOST_REQUIRE(conn_sock >= 0);
+
+    vector<unsigned char> expected(first);
+    expected.insert(expected.end(), second.begin(), second.end());
+    BOOST_CHECK(ReadBytes(conn_sock, expected.size()) == expected);
+
+    // Once the remote end closes, the pool must reconnect on the next send
+    close(conn_sock);
+    usleep(100000);
+
+    BOOST_CHECK_MESSAGE(pool.Send(peer,
+                                  [&first](int cli_sock) {
+                                      return WriteBytes(cli_sock, first);
+                                  }),
+                        "Send after remote close should reconnect");
+
+    conn_sock = accept(serv_sock, nullptr, nullptr);
+    BOOST_REQUIRE(conn_sock >= 0);
+    BOOST_CHECK(ReadBytes(conn_sock, first.size()) == first);
+
+    pool.Remove(peer);
+    BOOST_CHECK(pool.Size() == 0);
+
+    close(conn_sock);
+    close(serv_sock);
+}
+
+BOOST_AUTO_TEST_CASE(test_backoff)
+{
+    INIT_STDOUT_LOGGER();
+
+    // Nothing listens on this port
+    struct in_addr ip_addr;
+    inet_aton("127.0.0.1", &ip_addr);
+    Peer peer(ip_addr.s_addr, 1);
+
+    auto writer = [](int) { return true; };
+
+    BOOST_CHECK_MESSAGE(!ConnectionPool::GetInstance().Send(peer, writer),
+                        "Send to closed port should fail");
+    BOOST_CHECK_MESSAGE(!ConnectionPool::GetInstance().Send(peer, writer),
+                        "Send during backoff should fail fast");
+    BOOST_CHECK(ConnectionPool::GetInstance().Size() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
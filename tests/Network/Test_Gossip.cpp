@@ -0,0 +1,277 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "common/Constants.h"
+#include "common/Serializable.h"
+#include "libCrypto/Sha2.h"
+#include "libNetwork/Gossip.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE gossip
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+// Frame layout, see Gossip.h
+static const unsigned int TYPE_LEN = 1;
+static const unsigned int HASH_LEN = 32;
+static const unsigned int TIME_LEN = 8;
+static const unsigned int PORT_LEN = 4;
+static const unsigned int PUSH_HDR_LEN = TYPE_LEN + HASH_LEN + TIME_LEN;
+
+struct SentFrame
+{
+    vector<Peer> m_peers;
+    vector<unsigned char> m_frame;
+};
+
+static vector<SentFrame> sent;
+
+static void CaptureFrames()
+{
+    sent.clear();
+    Gossip::GetInstance().SetSender(
+        [](const vector<Peer>& peers, const Gossip::SharedBuffer& frame) {
+            sent.push_back({peers, *frame});
+        });
+}
+
+static vector<Peer> MakePeers(unsigned int count)
+{
+    vector<Peer> peers;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        peers.emplace_back(0x0100007F, 40000 + i);
+    }
+    return peers;
+}
+
+static vector<unsigned char> MakeMessage(unsigned char seed)
+{
+    // Unknown message type, so no broadcast list is needed on receipt
+    return vector<unsigned char>(64, seed);
+}
+
+static vector<unsigned char> HashOf(const vector<unsigned char>& message)
+{
+    SHA2<HASH_TYPE::HASH_VARIANT_256> sha256;
+    sha256.Update(message);
+    return sha256.Finalize();
+}
+
+static vector<unsigned char> MakePush(const vector<unsigned char>& message)
+{
+    const vector<unsigned char> hash = HashOf(message);
+
+    vector<unsigned char> frame = {Gossip::PUSH};
+    frame.insert(frame.end(), hash.begin(), hash.end());
+    Serializable::SetNumber<uint64_t>(frame, TYPE_LEN + HASH_LEN, 0, TIME_LEN);
+    frame.insert(frame.end(), message.begin(), message.end());
+    return frame;
+}
+
+static vector<unsigned char>
+MakeHashList(Gossip::Type type, uint32_t port,
+             const vector<vector<unsigned char>>& hashes)
+{
+    vector<unsigned char> frame = {type};
+    Serializable::SetNumber<uint32_t>(frame, TYPE_LEN, port, PORT_LEN);
+    for (const auto& hash : hashes)
+    {
+        frame.insert(frame.end(), hash.begin(), hash.end());
+    }
+    return frame;
+}
+
+static bool ListsHash(const vector<unsigned char>& frame,
+                      const vector<unsigned char>& hash)
+{
+    for (unsigned int i = TYPE_LEN + PORT_LEN; i + HASH_LEN <= frame.size();
+         i += HASH_LEN)
+    {
+        if (equal(hash.begin(), hash.end(), frame.begin() + i))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static unsigned int CountPushes(const vector<unsigned char>& hash)
+{
+    unsigned int count = 0;
+    for (const auto& s : sent)
+    {
+        if (s.m_frame.front() == Gossip::PUSH
+            && equal(hash.begin(), hash.end(), s.m_frame.begin() + TYPE_LEN))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+static bool DigestLists(const vector<unsigned char>& hash)
+{
+    for (const auto& s : sent)
+    {
+        if (s.m_frame.front() == Gossip::DIGEST && ListsHash(s.m_frame, hash))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+BOOST_AUTO_TEST_SUITE(gossip)
+
+BOOST_AUTO_TEST_CASE(test_push_rounds)
+{
+    INIT_STDOUT_LOGGER();
+
+    CaptureFrames();
+    const vector<Peer> peers = MakePeers(GOSSIP_FANOUT * 3);
+    const vector<unsigned char> message = MakeMessage(1);
+    const vector<unsigned char> hash = HashOf(message);
+
+    Gossip::GetInstance().SpreadRumor(peers, message);
+
+    // The first round goes out right away, to a fanout of the peers
+    BOOST_REQUIRE_EQUAL(sent.size(), 1);
+    BOOST_CHECK_EQUAL(sent.front().m_peers.size(), GOSSIP_FANOUT);
+    BOOST_CHECK_EQUAL(sent.front().m_frame.front(), Gossip::PUSH);
+    BOOST_CHECK(equal(message.begin(), message.end(),
+                      sent.front().m_frame.begin() + PUSH_HDR_LEN));
+
+    // Spreading the same rumor again is a no-op
+    Gossip::GetInstance().SpreadRumor(peers, message);
+    BOOST_CHECK_EQUAL(sent.size(), 1);
+
+    for (unsigned int i = 0; i < GOSSIP_ROUNDS + 2; i++)
+    {
+        Gossip::GetInstance().RunRound();
+    }
+
+    BOOST_CHECK_EQUAL(CountPushes(hash), GOSSIP_ROUNDS);
+    BOOST_CHECK_MESSAGE(DigestLists(hash), "Live rumor missing from digest");
+}
+
+BOOST_AUTO_TEST_CASE(test_receive_push)
+{
+    INIT_STDOUT_LOGGER();
+
+    CaptureFrames();
+    const vector<unsigned char> message = MakeMessage(2);
+    const Peer from(0x0100007F, 41000);
+
+    vector<unsigned char> received;
+    BOOST_CHECK(Gossip::GetInstance().ProcessMessage(MakePush(message), from,
+                                                     nullptr, received));
+    BOOST_CHECK(received == message);
+
+    // A second copy is not dispatched again
+    received.clear();
+    BOOST_CHECK(!Gossip::GetInstance().ProcessMessage(MakePush(message), from,
+                                                      nullptr, received));
+
+    // Nor is a message that does not match its hash
+    vector<unsigned char> tampered = MakePush(MakeMessage(3));
+    tampered.back() ^= 0xFF;
+    BOOST_CHECK(!Gossip::GetInstance().ProcessMessage(move(tampered), from,
+                                                      nullptr, received));
+}
+
+BOOST_AUTO_TEST_CASE(test_digest_and_pull)
+{
+    INIT_STDOUT_LOGGER();
+
+    CaptureFrames();
+    const vector<unsigned char> known = MakeMessage(4);
+    const vector<unsigned char> unknown = MakeMessage(5);
+    const uint32_t port = 42000;
+    const Peer from(0x0100007F, 55555);
+
+    Gossip::GetInstance().SpreadRumor(MakePeers(1), known);
+    sent.clear();
+
+    // Only the rumor we miss is pulled, from the port the digest announced
+    vector<unsigned char> received;
+    Gossip::GetInstance().ProcessMessage(
+        MakeHashList(Gossip::DIGEST, port, {HashOf(known), HashOf(unknown)}),
+        from, nullptr, received);
+
+    BOOST_REQUIRE_EQUAL(sent.size(), 1);
+    BOOST_CHECK_EQUAL(sent.front().m_frame.front(), Gossip::PULL);
+    BOOST_CHECK(ListsHash(sent.front().m_frame, HashOf(unknown)));
+    BOOST_CHECK(!ListsHash(sent.front().m_frame, HashOf(known)));
+    BOOST_REQUIRE_EQUAL(sent.front().m_peers.size(), 1);
+    BOOST_CHECK_EQUAL(sent.front().m_peers.front().m_listenPortHost, port);
+    sent.clear();
+
+    // A pull is answered with the full push frame of each rumor we have
+    Gossip::GetInstance().ProcessMessage(
+        MakeHashList(Gossip::PULL, port, {HashOf(known), HashOf(unknown)}),
+        from, nullptr, received);
+
+    BOOST_REQUIRE_EQUAL(sent.size(), 1);
+    BOOST_CHECK_EQUAL(sent.front().m_frame.front(), Gossip::PUSH);
+    BOOST_CHECK(equal(known.begin(), known.end(),
+                      sent.front().m_frame.begin() + PUSH_HDR_LEN));
+    BOOST_CHECK_EQUAL(sent.front().m_peers.front().m_listenPortHost, port);
+}
+
+BOOST_AUTO_TEST_CASE(test_rumor_expiry)
+{
+    INIT_STDOUT_LOGGER();
+
+    CaptureFrames();
+    const vector<Peer> peers = MakePeers(GOSSIP_FANOUT);
+    const vector<unsigned char> message = MakeMessage(6);
+    const vector<unsigned char> hash = HashOf(message);
+
+    Gossip::GetInstance().SpreadRumor(peers, message);
+    for (unsigned int i = 0; i < GOSSIP_ROUNDS; i++)
+    {
+        Gossip::GetInstance().RunRound();
+    }
+
+    // Once pushing is over, the payload is only kept for anti-entropy
+    this_thread::sleep_for(chrono::milliseconds(GOSSIP_ROUND_INTERVAL_IN_MS)
+                           * (GOSSIP_ROUNDS * 2 + 1));
+    Gossip::GetInstance().RunRound();
+    sent.clear();
+
+    Gossip::GetInstance().RunRound();
+    BOOST_CHECK_MESSAGE(!DigestLists(hash), "Expired rumor still in digest");
+
+    vector<unsigned char> received;
+    Gossip::GetInstance().ProcessMessage(
+        MakeHashList(Gossip::PULL, 43000, {hash}), peers.front(), nullptr,
+        received);
+    BOOST_CHECK_EQUAL(CountPushes(hash), 0);
+
+    // The hash itself is still known, so a late copy is not dispatched again
+    BOOST_CHECK(!Gossip::GetInstance().ProcessMessage(
+        MakePush(message), peers.front(), nullptr, received));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <vector>
+
+#include "libNetwork/MessageCompressor.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE messagecompressor
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(messagecompressor)
+
+BOOST_AUTO_TEST_CASE(test_round_trip)
+{
+    INIT_STDOUT_LOGGER();
+
+    vector<unsigned char> message;
+    for (unsigned int i = 0; i < 64 * 1024; i++)
+    {
+        message.emplace_back((unsigned char)((i / 16) % 7));
+    }
+
+    vector<unsigned char> compressed;
+    BOOST_CHECK_MESSAGE(MessageCompressor::Compress(message, compressed),
+                        "Repetitive message was not compressed");
+    BOOST_CHECK_LT(compressed.size(), message.size());
+
+    vector<unsigned char> restored;
+    BOOST_CHECK(MessageCompressor::Decompress(
+        compressed.data(), compressed.size(), restored, message.size()));
+    BOOST_CHECK(restored == message);
+}
+
+BOOST_AUTO_TEST_CASE(test_incompressible)
+{
+    INIT_STDOUT_LOGGER();
+
+    vector<unsigned char> message(4096);
+    uint32_t x = 2463534242;
+    for (auto& c : message)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        c = (unsigned char)(x & 0xFF);
+    }
+
+    vector<unsigned char> compressed;
+    BOOST_CHECK_MESSAGE(!MessageCompressor::Compress(message, compressed),
+                        "Random message should be sent uncompressed");
+}
+
+BOOST_AUTO_TEST_CASE(test_reject_bad_input)
+{
+    INIT_STDOUT_LOGGER();
+
+    vector<unsigned char> message(8192, 0x5A);
+    vector<unsigned char> compressed;
+    BOOST_REQUIRE(MessageCompressor::Compress(message, compressed));
+
+    vector<unsigned char> restored;
+
+    // Claimed length above the cap
+    BOOST_CHECK(!MessageCompressor::Decompress(
+        compressed.data(), compressed.size(), restored, message.size() - 1));
+
+    // Truncated data
+    BOOST_CHECK(!MessageCompressor::Decompress(
+        compressed.data(), compressed.size() / 2, restored, message.size()));
+
+    // Prefix only
+    BOOST_CHECK(!MessageCompressor::Decompress(compressed.data(), 4, restored,
+                                               message.size()));
+}
+
+BOOST_AUTO_TEST_CASE(test_reject_inflated_length)
+{
+    INIT_STDOUT_LOGGER();
+
+    // Even the most repetitive input stays within the expansion bound
+    vector<unsigned char> message(4 * 1024 * 1024, 0);
+    vector<unsigned char> compressed;
+    BOOST_REQUIRE(MessageCompressor::Compress(message, compressed));
+
+    vector<unsigned char> restored;
+    BOOST_CHECK(MessageCompressor::Decompress(
+        compressed.data(), compressed.size(), restored, message.size()));
+    BOOST_CHECK(restored == message);
+
+    // A few bytes claiming a huge length are refused before allocating it
+    vector<unsigned char> bomb = {0x10, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00};
+    vector<unsigned char> untouched;
+    BOOST_CHECK(!MessageCompressor::Decompress(bomb.data(), bomb.size(),
+                                               untouched, 0x20000000));
+    BOOST_CHECK_EQUAL(untouched.capacity(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
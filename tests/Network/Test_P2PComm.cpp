@@ -235,7 +235,8 @@ int main()
 
     P2PComm::GetInstance().SendMessage(peers, message2);
 
-    vector<unsigned char> longMsg(1024 * 1024 * 1024, 'z');
+    // Stay below MAX_MESSAGE_SIZE, larger messages are rejected on receipt
+    vector<unsigned char> longMsg(128 * 1024 * 1024, 'z');
     longMsg.emplace_back('\0');
 
     startTime = chrono::high_resolution_clock::now();
@@ -0,0 +1,157 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "libUtils/Sequencer.h"
+
+#define BOOST_TEST_MODULE sequencer
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(sequencer)
+
+BOOST_AUTO_TEST_CASE(test_ticket_order)
+{
+    vector<int> order;
+
+    {
+        Sequencer sequencer;
+
+        auto t0 = sequencer.Reserve();
+        auto t1 = sequencer.Reserve();
+        auto t2 = sequencer.Reserve();
+        auto t3 = sequencer.Reserve();
+
+        // Submitted out of order, must still run in ticket order
+        sequencer.Submit(t3, [&order]() { order.push_back(3); });
+        sequencer.Submit(t1, [&order]() { order.push_back(1); });
+        sequencer.Skip(t2);
+
+        this_thread::sleep_for(chrono::milliseconds(50));
+        BOOST_CHECK_MESSAGE(order.empty(), "Job ran before an earlier ticket");
+
+        sequencer.Submit(t0, [&order]() { order.push_back(0); });
+    }
+
+    BOOST_CHECK(order == vector<int>({0, 1, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(test_scoped_ticket)
+{
+    vector<int> order;
+
+    {
+        Sequencer sequencer;
+
+        Sequencer::ScopedTicket t0(sequencer);
+
+        // Unwinding without a submit must release the ticket
+        try
+        {
+            Sequencer::ScopedTicket t1(sequencer);
+            throw runtime_error("failed before submit");
+        }
+        catch (const runtime_error&)
+        {
+        }
+
+        {
+            Sequencer::ScopedTicket t2(sequencer);
+            t2.Submit([&order]() { order.push_back(2); });
+        }
+
+        t0.Submit([&order]() { order.push_back(0); });
+    }
+
+    BOOST_CHECK(order == vector<int>({0, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(test_drain)
+{
+    Sequencer sequencer;
+    atomic<int> done{0};
+
+    auto t0 = sequencer.Reserve();
+    auto t1 = sequencer.Reserve();
+
+    thread late([&sequencer, &done, t0]() {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        sequencer.Submit(t0, [&done]() { done++; });
+    });
+
+    sequencer.Submit(t1, [&done]() {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        done++;
+    });
+
+    // Waits for the ticket still being prepared, and the slow job behind it
+    sequencer.Drain();
+    BOOST_CHECK_EQUAL(done, 2);
+    late.join();
+
+    // Nothing reserved since, so there is nothing to wait for
+    sequencer.Drain();
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_producers)
+{
+    const unsigned int num_threads = 8;
+    const unsigned int jobs_per_thread = 1000;
+
+    vector<uint64_t> order;
+
+    {
+        Sequencer sequencer;
+        vector<thread> producers;
+
+        for (unsigned int i = 0; i < num_threads; i++)
+        {
+            producers.emplace_back([&sequencer, &order]() {
+                for (unsigned int j = 0; j < jobs_per_thread; j++)
+                {
+                    auto ticket = sequencer.Reserve();
+                    if (j % 3 == 0)
+                    {
+                        this_thread::yield();
+                    }
+                    sequencer.Submit(ticket, [&order, ticket]() {
+                        order.push_back(ticket);
+                    });
+                }
+            });
+        }
+
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+    }
+
+    BOOST_REQUIRE(order.size() == num_threads * jobs_per_thread);
+    for (unsigned int i = 0; i < order.size(); i++)
+    {
+        BOOST_CHECK_EQUAL(order.at(i), i);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,7 @@
 
 #include <boost/multiprecision/cpp_int.hpp>
 #include <cstdint>
+#include <random>
 #include <vector>
 
 #include "common/Serializable.h"
@@ -56,4 +57,63 @@ BOOST_AUTO_TEST_CASE(testSerializable)
                                            32); // boost, fixed size
 }
 
+// The byte-at-a-time encoding that the fixed-width path must reproduce
+template<class number_type>
+vector<unsigned char> ReferenceBytes(const number_type& value,
+                                     unsigned int size)
+{
+    vector<unsigned char> v(size);
+    for (unsigned int i = 0; i < size; i++)
+    {
+        v.at(size - 1 - i)
+            = static_cast<unsigned char>((value >> (i * 8)) & 0xFF);
+    }
+    return v;
+}
+
+template<class number_type> void testFixedWidth(unsigned int bits)
+{
+    mt19937_64 rng(bits);
+
+    for (unsigned int round = 0; round < 1000; round++)
+    {
+        // Mix small values with ones that fill every limb
+        number_type n = 0;
+        for (unsigned int i = round % (bits / 64 + 1); i > 0; i--)
+        {
+            n = (n << 64) | number_type(rng());
+        }
+
+        for (unsigned int size = 1; size <= bits / 8 + 8; size++)
+        {
+            vector<unsigned char> v = {0xAA};
+            Serializable::SetNumber<number_type>(v, 1, n, size);
+            BOOST_REQUIRE(v.size() == size + 1);
+            BOOST_REQUIRE(v.front() == 0xAA);
+            BOOST_REQUIRE(vector<unsigned char>(v.begin() + 1, v.end())
+                          == ReferenceBytes(n, size));
+
+            number_type expected = n;
+            if (size < bits / 8)
+            {
+                expected &= (number_type(1) << (size * 8)) - 1;
+            }
+            BOOST_REQUIRE(Serializable::GetNumber<number_type>(v, 1, size)
+                          == expected);
+            BOOST_REQUIRE(Serializable::GetNumber<number_type>(v, 2, size)
+                          == 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testFixedWidthMatchesShifts)
+{
+    INIT_STDOUT_LOGGER();
+
+    LOG_MARKER();
+
+    testFixedWidth<boost::multiprecision::uint128_t>(128);
+    testFixedWidth<boost::multiprecision::uint256_t>(256);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,62 @@
+/**
+* Copyright (c) 2018 Zilliqa 
+* This source code is being disclosed to you solely for the purpose of your participation in 
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to 
+* the protocols and algorithms that are programmed into, and intended by, the code. You may 
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd., 
+* including modifying or publishing the code (or any part of it), and developing or forming 
+* another public or private blockchain network. This source code is provided ‘as is’ and no 
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose 
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed. 
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at 
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by 
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends 
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <chrono>
+#include <vector>
+
+#include "common/Serializable.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE serializableperformance
+#include <boost/test/included/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(serializableperformance)
+
+BOOST_AUTO_TEST_CASE(testFixedWidthThroughput)
+{
+    INIT_STDOUT_LOGGER();
+
+    LOG_MARKER();
+
+    const unsigned int count = 100000;
+    boost::multiprecision::uint256_t n = 1;
+    n = (n << 255) - 12345;
+
+    vector<unsigned char> v;
+    boost::multiprecision::uint256_t sum = 0;
+
+    auto start = chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        Serializable::SetNumber<boost::multiprecision::uint256_t>(v, 0, n + i,
+                                                                 32);
+        sum += Serializable::GetNumber<boost::multiprecision::uint256_t>(v, 0,
+                                                                         32);
+    }
+    auto end = chrono::high_resolution_clock::now();
+
+    BOOST_CHECK(sum
+                == n * count
+                    + boost::multiprecision::uint256_t(count - 1) * count / 2);
+
+    double rate = count / chrono::duration<double, milli>(end - start).count();
+    LOG_GENERAL(INFO, "uint256_t set+get: " << rate << " per ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
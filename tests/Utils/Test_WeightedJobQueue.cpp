@@ -0,0 +1,96 @@
+/**
+* Copyright (c) 2018 Zilliqa
+* This source code is being disclosed to you solely for the purpose of your participation in
+* testing Zilliqa. You may view, compile and run the code for that purpose and pursuant to
+* the protocols and algorithms that are programmed into, and intended by, the code. You may
+* not do anything else with the code without express permission from Zilliqa Research Pte. Ltd.,
+* including modifying or publishing the code (or any part of it), and developing or forming
+* another public or private blockchain network. This source code is provided ‘as is’ and no
+* warranties are given as to title or non-infringement, merchantability or fitness for purpose
+* and, to the extent permitted by law, all liability for your use of the code is disclaimed.
+* Some programs in this code are governed by the GNU General Public License v3.0 (available at
+* https://www.gnu.org/licenses/gpl-3.0.en.html) (‘GPLv3’). The programs that are governed by
+* GPLv3.0 are those programs that are located in the folders src/depends and tests/depends
+* and which include a reference to GPLv3 in their program files.
+**/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "libUtils/WeightedJobQueue.h"
+
+#define BOOST_TEST_MODULE weightedjobqueue
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(weightedjobqueue)
+
+BOOST_AUTO_TEST_CASE(test_weighted_order)
+{
+    WeightedJobQueue<int> queue({3, 1}, {100, 100});
+
+    for (int i = 0; i < 6; i++)
+    {
+        queue.Push(0, i);
+        queue.Push(1, 100 + i);
+    }
+
+    // Three from the first class for every one from the second
+    vector<int> expected = {0, 1, 2, 100, 3, 4, 5, 101, 102, 103, 104, 105};
+    for (int e : expected)
+    {
+        BOOST_CHECK_EQUAL(queue.Pop(), e);
+    }
+
+    int job;
+    BOOST_CHECK(!queue.TryPop(job));
+}
+
+BOOST_AUTO_TEST_CASE(test_high_priority_not_starved)
+{
+    WeightedJobQueue<int> queue({4, 1}, {100, 100});
+
+    for (int i = 0; i < 50; i++)
+    {
+        queue.Push(1, i);
+    }
+
+    BOOST_CHECK_EQUAL(queue.Pop(), 0);
+
+    // A job of the first class arriving behind a backlog gets out right after the current turn
+    queue.Push(0, 1000);
+    BOOST_CHECK_EQUAL(queue.Pop(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(test_depths_and_limit)
+{
+    WeightedJobQueue<int> queue({1, 1}, {2, 8});
+
+    queue.Push(0, 1);
+    queue.Push(0, 2);
+    queue.Push(1, 3);
+
+    vector<size_t> depths = queue.Depths();
+    BOOST_CHECK_EQUAL(depths.at(0), 2);
+    BOOST_CHECK_EQUAL(depths.at(1), 1);
+
+    // The full class blocks its producer until a consumer makes room
+    atomic<bool> pushed(false);
+    thread producer([&queue, &pushed]() {
+        queue.Push(0, 4);
+        pushed = true;
+    });
+
+    this_thread::sleep_for(chrono::milliseconds(100));
+    BOOST_CHECK(!pushed);
+
+    queue.Pop();
+    producer.join();
+    BOOST_CHECK(pushed);
+    BOOST_CHECK_EQUAL(queue.PeakDepths().at(0), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
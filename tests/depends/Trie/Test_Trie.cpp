@@ -3,6 +3,7 @@
 * This is an alpha (internal) release and is not suitable for production.
 **/
 
+#include <algorithm>
 #include <arpa/inet.h>
 #include <array>
 #include <string>
@@ -12,6 +13,8 @@
 #define BOOST_TEST_MODULE trietest
 #include <boost/filesystem/path.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
 #include <boost/test/included/unit_test.hpp>
 
 #include "depends/common/CommonIO.h"
@@ -478,6 +481,50 @@ BOOST_AUTO_TEST_CASE(fat_trie)
 //     }
 // }
 
+BOOST_AUTO_TEST_CASE(trie_anyorder_vectors)
+{
+    INIT_STDOUT_LOGGER();
+
+    LOG_MARKER();
+
+    // Checks the trie node hashing (Keccak-256) against the reference roots
+    boost::property_tree::ptree tests;
+    boost::property_tree::read_json(
+        string(TRIE_TESTS_DIR) + "/trieanyorder.json", tests);
+    BOOST_REQUIRE(!tests.empty());
+
+    auto decode = [](const string& s) -> bytes {
+        return s.find("0x") == 0 ? fromHex(s.substr(2)) : asBytes(s);
+    };
+
+    for (const auto& test : tests)
+    {
+        vector<pair<bytes, bytes>> items;
+        for (const auto& item : test.second.get_child("in"))
+        {
+            items.emplace_back(decode(item.first),
+                               decode(item.second.get_value<string>()));
+        }
+
+        // Insertion order must not change the root
+        for (unsigned int order = 0; order < 2; order++)
+        {
+            MemoryDB m;
+            GenericTrieDB<MemoryDB> t(&m);
+            t.init();
+            for (const auto& kv : items)
+            {
+                t.insert(kv.first, kv.second);
+            }
+            BOOST_CHECK_MESSAGE(toHexPrefixed(t.root().asArray())
+                                    == test.second.get<string>("root"),
+                                "Root mismatch in " << test.first);
+
+            reverse(items.begin(), items.end());
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(trieLowerBound)
 {
     LOG_GENERAL(INFO, "Stress-testing Trie.lower_bound...");